@@ -0,0 +1,105 @@
+#include "headers/ActivityManager.h"
+#include "headers/Camera.h"
+#include "headers/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+bool ActivityManager::dormantByDefault = false;
+float ActivityManager::margin = 2.0f;
+std::unordered_map<int, RigidBody*> ActivityManager::candidates;
+std::unordered_map<const RigidBody*, bool> ActivityManager::canGoDormant;
+std::vector<int> ActivityManager::dormantIds;
+
+void ActivityManager::Update(float viewHalfWidth, float viewHalfHeight) {
+    dormantIds.clear();
+    if (candidates.empty()) {
+        return;
+    }
+    ProfileScope scope("ActivityManager::Update");
+
+    float reachX = viewHalfWidth + margin;
+    float reachY = viewHalfHeight + margin;
+    for (const auto& [actorId, body] : candidates) {
+        if (!body->m_body || body->m_body->IsAwake()) {
+            continue;
+        }
+
+        const b2Vec2& position = body->m_body->GetPosition();
+        if (std::fabs(position.x - CameraBounds::cam_x_pos) > reachX || std::fabs(position.y - CameraBounds::cam_y_pos) > reachY) {
+            dormantIds.push_back(actorId);
+        }
+    }
+    std::sort(dormantIds.begin(), dormantIds.end());
+}
+
+void ActivityManager::Register(Actor* actor, RigidBody* body) {
+    auto it = canGoDormant.find(body);
+    bool allowed = it == canGoDormant.end() ? dormantByDefault : it->second;
+    if (allowed) {
+        candidates[actor->GetID()] = body;
+    }
+}
+
+void ActivityManager::Unregister(int actorId) {
+    candidates.erase(actorId);
+    auto it = std::lower_bound(dormantIds.begin(), dormantIds.end(), actorId);
+    if (it != dormantIds.end() && *it == actorId) {
+        dormantIds.erase(it);
+    }
+}
+
+void ActivityManager::Clear() {
+    candidates.clear();
+    dormantIds.clear();
+}
+
+void ActivityManager::CopySettings(const RigidBody* from, const RigidBody* to) {
+    auto it = canGoDormant.find(from);
+    if (it != canGoDormant.end()) {
+        canGoDormant[to] = it->second;
+    }
+    else {
+        canGoDormant.erase(to);
+    }
+}
+
+bool ActivityManager::IsAwake(const RigidBody* body) {
+    return body->m_body != nullptr && body->m_body->IsAwake();
+}
+
+void ActivityManager::SetAwake(RigidBody* body, bool awake) {
+    if (body->m_body != nullptr) {
+        body->m_body->SetAwake(awake);
+    }
+}
+
+bool ActivityManager::IsSleepingAllowed(const RigidBody* body) {
+    return body->m_body == nullptr || body->m_body->IsSleepingAllowed();
+}
+
+void ActivityManager::SetSleepingAllowed(RigidBody* body, bool allowed) {
+    if (body->m_body != nullptr) {
+        body->m_body->SetSleepingAllowed(allowed);
+    }
+}
+
+bool ActivityManager::GetCanGoDormant(const RigidBody* body) {
+    auto it = canGoDormant.find(body);
+    return it == canGoDormant.end() ? dormantByDefault : it->second;
+}
+
+void ActivityManager::SetCanGoDormant(RigidBody* body, bool allowed) {
+    canGoDormant[body] = allowed;
+    if (body->m_body != nullptr && body->actor != nullptr) {
+        if (allowed) {
+            candidates[body->actor->GetID()] = body;
+        }
+        else {
+            Unregister(body->actor->GetID());
+        }
+    }
+}
+
+bool ActivityManager::IsDormant(const Actor* actor) {
+    return std::binary_search(dormantIds.begin(), dormantIds.end(), actor->GetID());
+}
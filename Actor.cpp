@@ -2,6 +2,12 @@
 #include "headers/MainHelper.h"
 #include "headers/Template.h"
 #include "headers/RigidBody.h"
+#include "headers/ComponentDispatch.h"
+#include "headers/ActorRegistry.h"
+#include "headers/CollisionFilters.h"
+#include "headers/ActivityManager.h"
+#include "headers/PhysicsClock.h"
+#include "headers/ActorPool.h"
 // Define the static member outside the class
 int Actor::next_id = 0;
 int Actor::globalComponentCounter = 0;
@@ -30,6 +36,8 @@ void Actor::deepCopyComponentsFrom(const Actor& other) {
         if ((*pair.second)["type"].cast<std::string>() == "Rigidbody") {
             RigidBody& original = (*pair.second).cast<RigidBody&>();
             RigidBody *copy = new RigidBody(original);
+            CollisionFilters::CopySettings(&original, copy);
+            ActivityManager::CopySettings(&original, copy);
             luabridge::LuaRef RigidBodyRef(LuaHelper::L, copy);
             actor_components[pair.first] = std::make_shared<luabridge::LuaRef>(RigidBodyRef);
            
@@ -77,7 +85,6 @@ luabridge::LuaRef Actor::GetComponent(const std::string& typeName) const {
 luabridge::LuaRef Actor::GetComponents(const std::string& typeName, lua_State* L) const {
     luabridge::LuaRef table = luabridge::newTable(L);
     int index = 1;
-    std::cout << actor_name << std::endl;
     for (const auto& component : actor_components) {
         if (component.second && (*component.second)["type"].cast<std::string>() == typeName) {
             table[index++] = luabridge::LuaRef(*component.second);
@@ -87,16 +94,12 @@ luabridge::LuaRef Actor::GetComponents(const std::string& typeName, lua_State* L
 }
 
 luabridge::LuaRef Actor::Find(const std::string& name) {
-    for (const auto& actor : hardcoded_actors) {
-        if (actor->GetName() == name) {
-            return luabridge::LuaRef(LuaHelper::L, actor.get());
-        }
+    if (Actor* actor = ActorRegistry::FindFirstByName(name)) {
+        return luabridge::LuaRef(LuaHelper::L, actor);
     }
 
-    for (const auto& actor : deferredActorAdditions) {
-        if (actor->GetName() == name) {
-            return luabridge::LuaRef(LuaHelper::L, actor.get());
-        }
+    if (Actor* actor = ActorRegistry::FindFirstPendingByName(name)) {
+        return luabridge::LuaRef(LuaHelper::L, actor);
     }
 
 
@@ -105,15 +108,16 @@ luabridge::LuaRef Actor::Find(const std::string& name) {
 
 std::vector<luabridge::LuaRef> Actor::FindAll(const std::string& name) {
     std::vector<luabridge::LuaRef> foundActors;
-    for (const auto& actor : hardcoded_actors) {
-        if (actor->GetName() == name) {
-            foundActors.push_back(luabridge::LuaRef(LuaHelper::L, actor.get()));
+    if (const auto* liveActors = ActorRegistry::FindAllByName(name)) {
+        foundActors.reserve(liveActors->size());
+        for (const auto& [id, actor] : *liveActors) {
+            foundActors.push_back(luabridge::LuaRef(LuaHelper::L, actor));
         }
     }
 
-    for (const auto& actor : deferredActorAdditions) {
-        if (actor->GetName() == name) {
-            foundActors.push_back(luabridge::LuaRef(LuaHelper::L, actor.get()));
+    if (const auto* pendingActors = ActorRegistry::FindAllPendingByName(name)) {
+        for (const auto& [id, actor] : *pendingActors) {
+            foundActors.push_back(luabridge::LuaRef(LuaHelper::L, actor));
         }
     }
     return foundActors;
@@ -127,6 +131,7 @@ luabridge::LuaRef Actor::addComponentFromLua(std::string componentName) {
     actor_components.insert({ key, componentRef });
     deferredComponentAdditions.push_back(componentRef);
     InjectConvenienceReferences(componentRef);
+    ComponentDispatch::RegisterComponent(this, key, componentRef);
     return *componentRef;
 }
 
@@ -154,12 +159,14 @@ void Actor::ProcessDeferredComponentRemovals() {
         if ((componentRef)["type"].cast<std::string>() == "Rigidbody") {
             RigidBody* rigidbody = (componentRef).cast<RigidBody*>();
             if (rigidbody && rigidbody->m_body && RigidBody::world) {
-                RigidBody::world->DestroyBody(rigidbody->m_body);
+                ActivityManager::Unregister(id);
+                PhysicsClock::DestroyBody(rigidbody->m_body);
             }
         }
 
         // Remove the component from the actor's components container
         if (it != actor_components.end()) {
+            ComponentDispatch::UnregisterComponent(this, key);
             actor_components.erase(it);
         }
     }
@@ -181,8 +188,16 @@ luabridge::LuaRef Actor::InstantiateNewActor(std::string templateName) {
                 std::exit(0);
             }
         }
-        actorInstance = std::make_shared<Actor>(*templateRawInstance);
-        actorInstance->deepCopyComponentsFrom(*templateRawInstance);
+        actorInstance = ActorPool::Acquire(templateName);
+        if (actorInstance) {
+            // Reused instances get a new id, so handles and queued events from their last life stay stale
+            actorInstance->id = next_id++;
+        }
+        else {
+            actorInstance = std::make_shared<Actor>(*templateRawInstance);
+            actorInstance->deepCopyComponentsFrom(*templateRawInstance);
+        }
+        ActorPool::Track(actorInstance->GetID(), templateName);
     }
     else {
         return luabridge::LuaRef(LuaHelper::L);
@@ -192,13 +207,14 @@ luabridge::LuaRef Actor::InstantiateNewActor(std::string templateName) {
         actorInstance->InjectConvenienceReferences(component.second);
     }
     deferredActorAdditions.push_back(actorInstance);
+    ActorRegistry::AddPending(actorInstance.get());
 
     return luabridge::LuaRef(LuaHelper::L, actorInstance.get());
 }
 
 void Actor::ProcessDeferredActorAdditions() {
     for (const auto &actor : deferredActorAdditions) {
-        hardcoded_actors.push_back(actor);
+        ActorRegistry::Add(actor);
     }
     deferredActorAdditions.clear();
 }
@@ -209,7 +225,7 @@ void Actor::DestoryActorFromLua(Actor* DeleteMe) {
     toDelete.first = DeleteMe->actor_name;
     toDelete.second = DeleteMe->GetID();
     deferredActorDeletions.push_back(toDelete);
-    DeleteMe->actor_name = "";
+    ActorRegistry::Rename(DeleteMe, "");
 
     for (auto& componentRef : DeleteMe->actor_components) {
         (*componentRef.second)["enabled"] = false;
@@ -220,34 +236,32 @@ void Actor::ProcessActorDeletions() {
 
     for (const auto& deletionPair : deferredActorDeletions) {
         // Find the actor to delete
-        auto it = std::find_if(hardcoded_actors.begin(), hardcoded_actors.end(),
-            [&deletionPair](const std::shared_ptr<Actor>& actor) {
-                return actor->GetID() == deletionPair.second;
-            });
+        std::shared_ptr<Actor> actor = ActorRegistry::GetShared(deletionPair.second);
 
-        if (it != hardcoded_actors.end()) {
+        if (actor) {
             // Call OnDestroy on all components of the actor
-            for (const auto& [key, componentRef] : (*it)->actor_components) {
+            for (const auto& [key, componentRef] : actor->actor_components) {
                 try {
                     if ((*componentRef)["OnDestroy"].isFunction()) {
                         (*componentRef)["OnDestroy"](*componentRef);
-
-                        // If it's a Rigidbody, call the Box2D world's DestroyBody method
-                        if ((*componentRef)["type"].cast<std::string>() == "Rigidbody") {
-                            RigidBody* rigidbody = (*componentRef).cast<RigidBody*>();
-                            RigidBody::world->DestroyBody(rigidbody->m_body);
-                           
-                        }
                     }
                 }
                 
                 catch (const luabridge::LuaException& e) {
-                    ReportError((*it)->actor_name, e);
+                    ReportError(actor->actor_name, e);
+                }
+
+                // Rigidbody has no OnDestroy, so its b2Body goes here; left alive it keeps
+                // colliding with fixtures that point at this (possibly pooled) actor
+                if ((*componentRef)["type"].isString() && (*componentRef)["type"].cast<std::string>() == "Rigidbody") {
+                    PhysicsClock::DestroyBody((*componentRef).cast<RigidBody*>()->m_body);
                 }
             }
 
-            // After calling OnDestroy, erase the actor from the list
-            hardcoded_actors.erase(it);
+            // After calling OnDestroy, swap-and-pop the actor out of the registry
+            // and hand it back to its template's pool, if it has one
+            ActorRegistry::Remove(actor->GetID());
+            ActorPool::Release(actor);
         }
     }
 
@@ -269,6 +283,7 @@ void Actor::UpdateActors() {
 
 void Actor::clearAll() {
     deferredActorAdditions.clear();
+    ActorRegistry::ClearPending();
     deferredActorDeletions.clear();
 }
 
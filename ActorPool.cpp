@@ -0,0 +1,152 @@
+#include "headers/ActorPool.h"
+#include "headers/MainHelper.h"
+#include "headers/RigidBody.h"
+#include "headers/CollisionFilters.h"
+#include "headers/ActivityManager.h"
+#include "headers/PhysicsClock.h"
+#include "headers/ComponentDispatch.h"
+
+std::unordered_map<std::string, ActorPool::Pool> ActorPool::pools;
+std::unordered_map<int, std::string> ActorPool::instances;
+
+void ActorPool::Configure(const std::string& templateName, const Actor& actorTemplate, int prewarm, int maxSize) {
+    Pool& pool = pools[templateName];
+    pool.actorTemplate = &actorTemplate;
+    pool.maxSize = maxSize > 0 ? static_cast<size_t>(maxSize) : 0;
+
+    pool.available.reserve(prewarm > 0 ? prewarm : 0);
+    for (int i = 0; i < prewarm; ++i) {
+        std::shared_ptr<Actor> instance = std::make_shared<Actor>(actorTemplate);
+        instance->deepCopyComponentsFrom(actorTemplate);
+        pool.available.push_back(instance);
+        pool.created++;
+    }
+}
+
+std::shared_ptr<Actor> ActorPool::Acquire(const std::string& templateName) {
+    auto it = pools.find(templateName);
+    if (it == pools.end()) {
+        return nullptr;
+    }
+
+    Pool& pool = it->second;
+    if (pool.available.empty()) {
+        pool.created++; // the caller builds a new one
+        return nullptr;
+    }
+
+    std::shared_ptr<Actor> instance = std::move(pool.available.back());
+    pool.available.pop_back();
+    pool.reused++;
+    return instance;
+}
+
+void ActorPool::Track(int actorId, const std::string& templateName) {
+    auto it = pools.find(templateName);
+    if (it != pools.end()) {
+        instances[actorId] = templateName;
+        it->second.inUse++;
+    }
+}
+
+bool ActorPool::Release(const std::shared_ptr<Actor>& actor) {
+    auto instance = instances.find(actor->GetID());
+    if (instance == instances.end()) {
+        return false;
+    }
+    auto it = pools.find(instance->second);
+    instances.erase(instance);
+    if (it == pools.end()) {
+        return false;
+    }
+
+    Pool& pool = it->second;
+    pool.inUse--;
+    if ((pool.maxSize > 0 && pool.available.size() >= pool.maxSize) || !matchesTemplate(*actor, *pool.actorTemplate)) {
+        return false;
+    }
+
+    reset(*actor, *pool.actorTemplate);
+    pool.available.push_back(actor);
+    return true;
+}
+
+bool ActorPool::matchesTemplate(const Actor& actor, const Actor& actorTemplate) {
+    if (actor.actor_components.size() != actorTemplate.actor_components.size()) {
+        return false;
+    }
+    for (const auto& [key, componentRef] : actor.actor_components) {
+        if (actorTemplate.actor_components.find(key) == actorTemplate.actor_components.end()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ActorPool::reset(Actor& actor, const Actor& actorTemplate) {
+    lua_State* L = LuaHelper::L;
+    actor.actor_name = actorTemplate.actor_name;
+
+    for (auto& [key, componentRef] : actor.actor_components) {
+        luabridge::LuaRef& component = *componentRef;
+        if (component.isTable()) {
+            // Drop every field set on the instance; reads fall through to the
+            // template component again, exactly like a fresh copy
+            component.push(L);
+            lua_pushnil(L);
+            while (lua_next(L, -2) != 0) {
+                lua_pop(L, 1);
+                lua_pushvalue(L, -1);
+                lua_pushnil(L);
+                lua_rawset(L, -4);
+            }
+            lua_pop(L, 1);
+            ComponentDispatch::ForgetAssignedFunctions(component);
+        }
+        else if (component["type"].isString() && component["type"].cast<std::string>() == "Rigidbody") {
+            // ProcessActorDeletions destroyed the b2Body already; make sure none is
+            // orphaned by the copy below. OnStart creates a new one on reuse.
+            RigidBody* body = component.cast<RigidBody*>();
+            PhysicsClock::DestroyBody(body->m_body);
+            const RigidBody* original = (*actorTemplate.actor_components.at(key)).cast<RigidBody*>();
+            *body = RigidBody(*original);
+            CollisionFilters::CopySettings(original, body);
+            ActivityManager::CopySettings(original, body);
+        }
+    }
+}
+
+void ActorPool::ForgetInstances() {
+    instances.clear();
+    for (auto& [name, pool] : pools) {
+        pool.inUse = 0;
+    }
+}
+
+void ActorPool::Clear() {
+    pools.clear();
+    instances.clear();
+}
+
+luabridge::LuaRef ActorPool::GetStats(const std::string& templateName, lua_State* L) {
+    auto it = pools.find(templateName);
+    if (it == pools.end()) {
+        return luabridge::LuaRef(L);
+    }
+
+    const Pool& pool = it->second;
+    luabridge::LuaRef stats = luabridge::newTable(L);
+    stats["available"] = static_cast<int>(pool.available.size());
+    stats["in_use"] = static_cast<int>(pool.inUse);
+    stats["created"] = static_cast<int>(pool.created);
+    stats["reused"] = static_cast<int>(pool.reused);
+    return stats;
+}
+
+size_t ActorPool::AvailableCount() {
+    size_t total = 0;
+    for (const auto& [name, pool] : pools) {
+        total += pool.available.size();
+    }
+    return total;
+}
@@ -0,0 +1,208 @@
+#include "headers/ActorRegistry.h"
+#include "headers/ComponentDispatch.h"
+#include "headers/SpatialIndex.h"
+#include "headers/CollisionEvents.h"
+#include "headers/ActivityManager.h"
+#include "headers/ActorPool.h"
+
+extern std::vector<std::shared_ptr<Actor>> hardcoded_actors;
+
+std::vector<ActorRegistry::Slot> ActorRegistry::slots;
+std::vector<uint32_t> ActorRegistry::freeSlots;
+std::vector<uint32_t> ActorRegistry::denseSlots;
+std::unordered_map<int, uint32_t> ActorRegistry::slotById;
+std::unordered_map<std::string, std::map<int, Actor*>> ActorRegistry::byName;
+std::unordered_map<std::string, std::map<int, Actor*>> ActorRegistry::pendingByName;
+std::unordered_map<std::string, uint64_t> ActorRegistry::nameVersions;
+
+ActorHandle ActorRegistry::Add(const std::shared_ptr<Actor>& actor) {
+    auto existing = slotById.find(actor->GetID());
+    if (existing != slotById.end()) {
+        return { existing->second, slots[existing->second].generation };
+    }
+
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slot = static_cast<uint32_t>(slots.size());
+        slots.push_back({ 0, 0 });
+    }
+
+    slots[slot].denseIndex = static_cast<uint32_t>(hardcoded_actors.size());
+    hardcoded_actors.push_back(actor);
+    denseSlots.push_back(slot);
+    slotById[actor->GetID()] = slot;
+    byName[actor->actor_name][actor->GetID()] = actor.get();
+    if (!removeFromNameIndex(pendingByName, actor->actor_name, actor->GetID())) {
+        nameVersions[actor->actor_name]++;
+    }
+
+    ComponentDispatch::RegisterActor(actor.get());
+    return { slot, slots[slot].generation };
+}
+
+bool ActorRegistry::removeFromNameIndex(std::unordered_map<std::string, std::map<int, Actor*>>& index, const std::string& name, int actorId) {
+    auto it = index.find(name);
+    if (it == index.end() || it->second.erase(actorId) == 0) {
+        return false;
+    }
+    if (it->second.empty()) {
+        index.erase(it);
+    }
+    return true;
+}
+
+void ActorRegistry::bumpAllNameVersions() {
+    for (auto& [name, version] : nameVersions) {
+        version++;
+    }
+}
+
+bool ActorRegistry::Remove(int actorId) {
+    auto found = slotById.find(actorId);
+    if (found == slotById.end()) {
+        return false;
+    }
+
+    uint32_t slot = found->second;
+    uint32_t denseIndex = slots[slot].denseIndex;
+    Actor* actor = hardcoded_actors[denseIndex].get();
+
+    ComponentDispatch::UnregisterActor(actor);
+    SpatialIndex::Remove(actorId);
+    ActivityManager::Unregister(actorId);
+    removeFromNameIndex(byName, actor->actor_name, actorId);
+    nameVersions[actor->actor_name]++;
+    slotById.erase(found);
+
+    // Swap the last actor into the hole and pop
+    uint32_t lastIndex = static_cast<uint32_t>(hardcoded_actors.size() - 1);
+    if (denseIndex != lastIndex) {
+        hardcoded_actors[denseIndex] = std::move(hardcoded_actors[lastIndex]);
+        denseSlots[denseIndex] = denseSlots[lastIndex];
+        slots[denseSlots[denseIndex]].denseIndex = denseIndex;
+    }
+    hardcoded_actors.pop_back();
+    denseSlots.pop_back();
+
+    slots[slot].generation++;
+    freeSlots.push_back(slot);
+    return true;
+}
+
+void ActorRegistry::Clear() {
+    hardcoded_actors.clear();
+    slots.clear();
+    freeSlots.clear();
+    denseSlots.clear();
+    slotById.clear();
+    byName.clear();
+    bumpAllNameVersions();
+    ComponentDispatch::Clear();
+    SpatialIndex::Clear();
+    CollisionEvents::Clear();
+    ActivityManager::Clear();
+    ActorPool::ForgetInstances();
+}
+
+Actor* ActorRegistry::Get(ActorHandle handle) {
+    if (handle.slot >= slots.size() || slots[handle.slot].generation != handle.generation) {
+        return nullptr;
+    }
+    uint32_t denseIndex = slots[handle.slot].denseIndex;
+    if (denseIndex >= denseSlots.size() || denseSlots[denseIndex] != handle.slot) {
+        return nullptr; // slot is on the free list
+    }
+    return hardcoded_actors[denseIndex].get();
+}
+
+std::shared_ptr<Actor> ActorRegistry::GetShared(int actorId) {
+    auto found = slotById.find(actorId);
+    if (found == slotById.end()) {
+        return nullptr;
+    }
+    return hardcoded_actors[slots[found->second].denseIndex];
+}
+
+ActorHandle ActorRegistry::HandleOf(int actorId) {
+    auto found = slotById.find(actorId);
+    if (found == slotById.end()) {
+        return {};
+    }
+    return { found->second, slots[found->second].generation };
+}
+
+Actor* ActorRegistry::FindFirstByName(const std::string& name) {
+    auto it = byName.find(name);
+    if (it == byName.end()) {
+        return nullptr;
+    }
+    return it->second.begin()->second;
+}
+
+const std::map<int, Actor*>* ActorRegistry::FindAllByName(const std::string& name) {
+    auto it = byName.find(name);
+    if (it == byName.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void ActorRegistry::AddPending(Actor* actor) {
+    pendingByName[actor->actor_name][actor->GetID()] = actor;
+    nameVersions[actor->actor_name]++;
+}
+
+Actor* ActorRegistry::FindFirstPendingByName(const std::string& name) {
+    auto it = pendingByName.find(name);
+    if (it == pendingByName.end()) {
+        return nullptr;
+    }
+    return it->second.begin()->second;
+}
+
+const std::map<int, Actor*>* ActorRegistry::FindAllPendingByName(const std::string& name) {
+    auto it = pendingByName.find(name);
+    if (it == pendingByName.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void ActorRegistry::ClearPending() {
+    pendingByName.clear();
+    bumpAllNameVersions();
+}
+
+uint64_t ActorRegistry::NameVersion(const std::string& name) {
+    auto it = nameVersions.find(name);
+    return it == nameVersions.end() ? 0 : it->second;
+}
+
+void ActorRegistry::Rename(Actor* actor, const std::string& newName) {
+    if (actor->actor_name == newName) return;
+
+    bool indexed = false;
+    if (slotById.count(actor->GetID())) {
+        removeFromNameIndex(byName, actor->actor_name, actor->GetID());
+        byName[newName][actor->GetID()] = actor;
+        indexed = true;
+    }
+    else if (removeFromNameIndex(pendingByName, actor->actor_name, actor->GetID())) {
+        pendingByName[newName][actor->GetID()] = actor;
+        indexed = true;
+    }
+
+    if (indexed) {
+        nameVersions[actor->actor_name]++;
+        nameVersions[newName]++;
+    }
+    actor->actor_name = newName;
+}
+
+size_t ActorRegistry::Count() {
+    return hardcoded_actors.size();
+}
@@ -0,0 +1,454 @@
+#include "headers/AssetPreloader.h"
+#include "headers/Actor.h"
+#include "headers/ImageDB.h"
+#include "headers/AudioDB.h"
+#include "headers/AudioHelper.h"
+#include "headers/TextDB.h"
+#include "headers/TextureAtlas.h"
+#include "headers/ImageDecoder.h"
+#include "headers/Profiler.h"
+#define _SILENCE_EXPERIMENTAL_FILESYSTEM_DEPRECATION_WARNING
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <unordered_set>
+#include "rapidjson/document.h"
+#include "rapidjson/filereadstream.h"
+
+bool AssetPreloader::enabled = true;
+std::unordered_map<std::string, SDL_Surface*> AssetPreloader::images;
+std::unordered_map<std::string, Mix_Chunk*> AssetPreloader::sounds;
+double AssetPreloader::lastDecodeMs = 0.0;
+double AssetPreloader::lastUploadMs = 0.0;
+size_t AssetPreloader::lastImages = 0;
+size_t AssetPreloader::lastSounds = 0;
+size_t AssetPreloader::lastFonts = 0;
+size_t AssetPreloader::totalPreloads = 0;
+
+extern std::string gamePlaying;
+extern std::vector<std::shared_ptr<Actor>> hardcoded_actors;
+
+namespace {
+    std::string imagePath(const std::string& gameFolder, const std::string& imageName) {
+        return "resources/" + gameFolder + "/images/" + imageName + ".png";
+    }
+}
+
+void AssetPreloader::PreloadScene(const std::string& scenePath, SDL_Renderer* renderer, size_t firstActor) {
+    if (!enabled) {
+        return;
+    }
+    ProfileScope scope("AssetPreloader::PreloadScene");
+
+    AssetList list = collectLoaded(scenePath, firstActor, gamePlaying);
+    auto start = std::chrono::steady_clock::now();
+
+    // Images are uploaded while the workers decode the rest
+    std::vector<std::string> names;
+    std::vector<std::string> paths;
+#ifndef ENGINE_HEADLESS
+    for (const std::string& imageName : list.images) {
+        if (!TextureAtlas::Find(imageName)) {
+            names.push_back(imageName);
+            paths.push_back(imagePath(list.gameFolder, imageName));
+        }
+    }
+#endif
+    double imageUploadMs = 0.0;
+    ImageDecoder::DecodeAll(paths, [&](size_t index, SDL_Surface* surface) {
+        auto uploadStart = std::chrono::steady_clock::now();
+        if (surface) {
+            uploadImage(names[index], surface, renderer);
+        }
+        std::chrono::duration<double, std::milli> uploadTime = std::chrono::steady_clock::now() - uploadStart;
+        imageUploadMs += uploadTime.count();
+        });
+
+    DecodedAssets decoded;
+    decodeSounds(list, decoded, nullptr, nullptr);
+    decoded.fonts = list.fonts;
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    decoded.decodeMs = elapsed.count() - imageUploadMs;
+
+    Upload(decoded, renderer);
+    lastImages = names.size();
+    lastUploadMs += imageUploadMs;
+}
+
+namespace {
+    enum AssetKind { kNotAsset = 0, kImage = 1, kSound = 2, kFont = 4 };
+
+    // What a string field names, checked once per distinct string
+    struct Classifier {
+        std::string gameFolder;
+        std::unordered_map<std::string, int> kinds;
+
+        int operator()(const std::string& name) {
+            auto it = kinds.find(name);
+            if (it != kinds.end()) {
+                return it->second;
+            }
+            int kind = kNotAsset;
+            std::error_code error;
+            if (!name.empty() && name.find_first_of("/\\") == std::string::npos) {
+#ifndef ENGINE_HEADLESS
+                if (std::filesystem::exists("resources/" + gameFolder + "/images/" + name + ".png", error)) {
+                    kind |= kImage;
+                }
+#endif
+                // Same lookup as AudioDB::LoadSoundEffect
+                if (std::filesystem::exists("resources/audio/" + name + ".wav", error)
+                    || std::filesystem::exists("resources/audio/" + name + ".ogg", error)) {
+                    kind |= kSound;
+                }
+                if (std::filesystem::exists("resources/" + gameFolder + "/fonts/" + name + ".ttf", error)) {
+                    kind |= kFont;
+                }
+            }
+            kinds.emplace(name, kind);
+            return kind;
+        }
+    };
+
+    // The fields of one component; fonts are preloaded at each of its "...size" ints
+    struct ComponentScan {
+        std::vector<std::string> fonts;
+        std::vector<int> sizes;
+
+        void intField(const std::string& name, int value) {
+            if (name.size() >= 4 && name.compare(name.size() - 4, 4, "size") == 0 && value > 0) {
+                sizes.push_back(value);
+            }
+        }
+
+        void stringField(const std::string& value, Classifier& classify, std::unordered_set<std::string>& seen, AssetList& list) {
+            int kind = classify(value);
+            if ((kind & kImage) && seen.insert("image:" + value).second) {
+                list.images.push_back(value);
+            }
+            if ((kind & kSound) && seen.insert("sound:" + value).second) {
+                list.sounds.push_back(value);
+            }
+            if (kind & kFont) {
+                fonts.push_back(value);
+            }
+        }
+
+        void finish(std::unordered_set<std::string>& seen, AssetList& list) const {
+            for (const std::string& font : fonts) {
+                for (int size : sizes) {
+                    if (seen.insert("font:" + font + ":" + std::to_string(size)).second) {
+                        list.fonts.emplace_back(font, size);
+                    }
+                }
+            }
+        }
+    };
+
+    void scanComponents(const CookedAsset& asset, Classifier& classify, std::unordered_set<std::string>& seen, AssetList& list) {
+        const Cooked::Header& header = asset.GetHeader();
+        for (uint32_t c = 0; c < header.componentCount; ++c) {
+            const Cooked::Component& component = asset.Components()[c];
+            ComponentScan scan;
+
+            for (uint32_t p = 0; p < component.propertyCount; ++p) {
+                const Cooked::Property& property = asset.Properties()[component.firstProperty + p];
+                if (property.kind == Cooked::PropertyKind::Int) {
+                    scan.intField(asset.String(property.name), property.intValue);
+                }
+                else if (property.kind == Cooked::PropertyKind::String) {
+                    scan.stringField(asset.String(property.string), classify, seen, list);
+                }
+            }
+            scan.finish(seen, list);
+        }
+    }
+
+    // The scene and template properties of a loaded component: its own fields and
+    // those of the tables it inherits from, short of the component type's script
+    // table, whose defaults the scene files never named either
+    void scanComponent(const luabridge::LuaRef& component, Classifier& classify, std::unordered_set<std::string>& seen, AssetList& list) {
+        if (!component.isTable()) {
+            return; // Rigidbody is userdata
+        }
+        lua_State* L = LuaHelper::L;
+        const luabridge::LuaRef* scriptTable = nullptr;
+        luabridge::LuaRef type = component["type"];
+        if (type.isString()) {
+            auto it = LuaHelper::component_tables.find(type.cast<std::string>());
+            if (it != LuaHelper::component_tables.end()) {
+                scriptTable = it->second.get();
+            }
+        }
+
+        ComponentScan scan;
+        std::unordered_set<std::string> shadowed; // an instance field hides the template's
+        luabridge::LuaRef table = component;
+        while (table.isTable() && !(scriptTable && table == *scriptTable)) {
+            for (luabridge::Iterator iter(table); !iter.isNil(); ++iter) {
+                if (!iter.key().isString()) {
+                    continue;
+                }
+                std::string name = iter.key().cast<std::string>();
+                if (!shadowed.insert(name).second) {
+                    continue;
+                }
+                luabridge::LuaRef value = iter.value();
+                if (value.isString()) {
+                    scan.stringField(value.cast<std::string>(), classify, seen, list);
+                }
+                else if (value.isNumber() && value.cast<double>() == std::floor(value.cast<double>())) {
+                    scan.intField(name, value.cast<int>());
+                }
+            }
+
+            // On to the table this one inherits from (LuaHelper::EstablishInheritance)
+            luabridge::LuaRef parent(L);
+            table.push(L);
+            if (lua_getmetatable(L, -1)) {
+                lua_getfield(L, -1, "__index");
+                parent = luabridge::LuaRef::fromStack(L, -1);
+                lua_pop(L, 2);
+            }
+            lua_pop(L, 1);
+            table = parent;
+        }
+        scan.finish(seen, list);
+    }
+}
+
+AssetList AssetPreloader::collectLoaded(const std::string& scenePath, size_t firstActor, const std::string& gameFolder) {
+    AssetList list;
+    list.gameFolder = gameFolder;
+    std::string manifestPath = std::filesystem::path{ scenePath }.replace_extension(".preload").string();
+    if (readManifest(manifestPath, list)) {
+        return list;
+    }
+
+    Classifier classify{ gameFolder, {} };
+    std::unordered_set<std::string> seen;
+    for (size_t i = firstActor; i < hardcoded_actors.size(); ++i) {
+        for (const auto& [key, componentRef] : hardcoded_actors[i]->actor_components) {
+            scanComponent(*componentRef, classify, seen, list);
+        }
+    }
+    return list;
+}
+
+AssetList AssetPreloader::Collect(const CookedAsset& scene, const std::string& scenePath, const std::string& gameFolder) {
+    AssetList list;
+    list.gameFolder = gameFolder;
+    std::string manifestPath = std::filesystem::path{ scenePath }.replace_extension(".preload").string();
+    if (readManifest(manifestPath, list)) {
+        return list;
+    }
+
+    Classifier classify{ gameFolder, {} };
+    std::unordered_set<std::string> seen;
+    scanComponents(scene, classify, seen, list);
+
+    std::unordered_set<uint32_t> templates;
+    const Cooked::Header& header = scene.GetHeader();
+    for (uint32_t i = 0; i < header.actorCount; ++i) {
+        uint32_t templateName = scene.Actors()[i].templateName;
+        if (templateName != Cooked::kNone && templates.insert(templateName).second) {
+            CookedAsset actorTemplate;
+            if (actorTemplate.Load("resources/" + gameFolder + "/actor_templates/" + scene.String(templateName) + ".template")) {
+                scanComponents(actorTemplate, classify, seen, list);
+            }
+        }
+    }
+    return list;
+}
+
+bool AssetPreloader::readManifest(const std::string& manifestPath, AssetList& list) {
+    std::error_code error;
+    if (!std::filesystem::exists(manifestPath, error)) {
+        return false;
+    }
+
+    FILE* file_pointer = nullptr;
+#ifdef _WIN32
+    fopen_s(&file_pointer, manifestPath.c_str(), "rb");
+#else
+    file_pointer = fopen(manifestPath.c_str(), "rb");
+#endif
+    if (!file_pointer) {
+        return false;
+    }
+    char buffer[65536];
+    rapidjson::FileReadStream stream(file_pointer, buffer, sizeof(buffer));
+    rapidjson::Document document;
+    document.ParseStream(stream);
+    std::fclose(file_pointer);
+    if (document.HasParseError() || !document.IsObject()) {
+        std::cout << "error parsing json at [" << manifestPath << "]" << std::endl;
+        return false;
+    }
+
+    auto names = [&document](const char* member, std::vector<std::string>& out) {
+        if (document.HasMember(member) && document[member].IsArray()) {
+            for (const auto& value : document[member].GetArray()) {
+                if (value.IsString()) {
+                    out.push_back(value.GetString());
+                }
+            }
+        }
+    };
+#ifndef ENGINE_HEADLESS
+    names("images", list.images);
+#endif
+    names("sounds", list.sounds);
+    if (document.HasMember("fonts") && document["fonts"].IsArray()) {
+        for (const auto& font : document["fonts"].GetArray()) {
+            if (font.IsObject() && font.HasMember("name") && font["name"].IsString() && font.HasMember("size") && font["size"].IsInt()) {
+                list.fonts.emplace_back(font["name"].GetString(), font["size"].GetInt());
+            }
+        }
+    }
+    return true;
+}
+
+void AssetPreloader::Decode(const AssetList& list, DecodedAssets& out, const std::atomic<bool>* cancel, std::atomic<uint32_t>* done) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Off the main thread there is no renderer to upload to; the surfaces wait for Upload
+    std::vector<std::string> paths;
+    for (const std::string& imageName : list.images) {
+        paths.push_back(imagePath(list.gameFolder, imageName));
+    }
+    ImageDecoder::DecodeAll(paths, [&](size_t index, SDL_Surface* surface) {
+        if (surface && !out.images.emplace(list.images[index], surface).second) {
+            SDL_FreeSurface(surface);
+        }
+        if (done) {
+            (*done)++;
+        }
+        }, false, cancel);
+
+    decodeSounds(list, out, cancel, done);
+    out.fonts = list.fonts;
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    out.decodeMs = elapsed.count();
+}
+
+void AssetPreloader::decodeSounds(const AssetList& list, DecodedAssets& out, const std::atomic<bool>* cancel, std::atomic<uint32_t>* done) {
+    for (const std::string& sound : list.sounds) {
+        if (cancel && cancel->load()) {
+            break;
+        }
+        std::string wavPath = "resources/audio/" + sound + ".wav";
+        std::string oggPath = "resources/audio/" + sound + ".ogg";
+        Mix_Chunk* chunk = AudioHelper::Mix_LoadWAV498(wavPath.c_str());
+        if (!chunk) {
+            chunk = AudioHelper::Mix_LoadWAV498(oggPath.c_str());
+        }
+        if (chunk) {
+            out.sounds.emplace(sound, chunk);
+        }
+        if (done) {
+            (*done)++;
+        }
+    }
+}
+
+void AssetPreloader::Upload(DecodedAssets& assets, SDL_Renderer* renderer) {
+    ProfileScope scope("AssetPreloader::Upload");
+    auto start = std::chrono::steady_clock::now();
+    lastImages = assets.images.size();
+    lastSounds = assets.sounds.size();
+    lastFonts = assets.fonts.size();
+
+    for (auto& [imageName, surface] : assets.images) {
+        uploadImage(imageName, surface, renderer);
+    }
+    assets.images.clear();
+
+    for (auto& [soundName, chunk] : assets.sounds) {
+        if (!sounds.emplace(soundName, chunk).second) {
+            Mix_FreeChunk(chunk);
+        }
+    }
+    assets.sounds.clear();
+
+    for (const auto& [fontName, fontSize] : assets.fonts) {
+        TextDB::LoadFont(fontName, fontSize);
+    }
+    assets.fonts.clear();
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    lastDecodeMs = assets.decodeMs;
+    lastUploadMs = elapsed.count();
+    totalPreloads++;
+}
+
+void AssetPreloader::uploadImage(const std::string& imageName, SDL_Surface* surface, SDL_Renderer* renderer) {
+#ifndef ENGINE_HEADLESS
+    // Images the atlas covers are never loaded on their own, so those surfaces are just dropped
+    if (!TextureAtlas::Find(imageName)) {
+        images[imageName] = surface;
+        ImageDB::loadImage(imageName, renderer);
+        surface = TakeImage(imageName); // still here if it was cached already
+    }
+#endif
+    if (surface) {
+        SDL_FreeSurface(surface);
+    }
+}
+
+void AssetPreloader::Discard(DecodedAssets& assets) {
+    for (auto& [name, surface] : assets.images) {
+        SDL_FreeSurface(surface);
+    }
+    for (auto& [name, chunk] : assets.sounds) {
+        Mix_FreeChunk(chunk);
+    }
+    assets.images.clear();
+    assets.sounds.clear();
+    assets.fonts.clear();
+}
+
+SDL_Surface* AssetPreloader::TakeImage(const std::string& imageName) {
+    auto it = images.find(imageName);
+    if (it == images.end()) {
+        return nullptr;
+    }
+    SDL_Surface* surface = it->second;
+    images.erase(it);
+    return surface;
+}
+
+Mix_Chunk* AssetPreloader::TakeSound(const std::string& soundName) {
+    auto it = sounds.find(soundName);
+    if (it == sounds.end()) {
+        return nullptr;
+    }
+    Mix_Chunk* chunk = it->second;
+    sounds.erase(it);
+    return chunk;
+}
+
+void AssetPreloader::Clear() {
+    for (auto& [name, surface] : images) {
+        SDL_FreeSurface(surface);
+    }
+    for (auto& [name, chunk] : sounds) {
+        Mix_FreeChunk(chunk);
+    }
+    images.clear();
+    sounds.clear();
+}
+
+luabridge::LuaRef AssetPreloader::GetStats(lua_State* L) {
+    luabridge::LuaRef stats = luabridge::newTable(L);
+    stats["decode_ms"] = lastDecodeMs;
+    stats["upload_ms"] = lastUploadMs;
+    stats["images"] = static_cast<int>(lastImages);
+    stats["sounds"] = static_cast<int>(lastSounds);
+    stats["fonts"] = static_cast<int>(lastFonts);
+    stats["waiting_sounds"] = static_cast<int>(sounds.size());
+    stats["preloads"] = static_cast<int>(totalPreloads);
+    return stats;
+}
@@ -1,6 +1,7 @@
 // AudioDB.h
 
 #include "headers/AudioDB.h"
+#include "headers/AssetPreloader.h"
 
 std::unordered_map<std::string, Mix_Chunk*> AudioDB::audioClips;
 
@@ -23,6 +24,12 @@ void AudioDB::LoadSoundEffect(const std::string& storeVariable) {
         return;
     }
 
+    // Decoded ahead of time by AssetPreloader
+    if (Mix_Chunk* prepared = AssetPreloader::TakeSound(storeVariable)) {
+        audioClips[storeVariable] = prepared;
+        return;
+    }
+
     std::string wavPath = "resources/audio/" + storeVariable + ".wav";
     std::string oggPath = "resources/audio/" + storeVariable + ".ogg";
 
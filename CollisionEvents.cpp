@@ -0,0 +1,48 @@
+#include "headers/CollisionEvents.h"
+#include "headers/ActorRegistry.h"
+#include "headers/Profiler.h"
+
+std::vector<CollisionEvent> CollisionEvents::events;
+std::vector<CollisionEvent> CollisionEvents::dispatchingEvents;
+
+void CollisionEvents::Record(CollisionPhase phase, Actor* actorA, Actor* actorB, const b2Vec2& point, const b2Vec2& normal, const b2Vec2& relativeVelocity) {
+    // A sees B first, then B sees A, like the old synchronous calls
+    events.push_back({ phase, actorA, actorA->GetID(), actorB, actorB->GetID(), point, normal, relativeVelocity });
+    events.push_back({ phase, actorB, actorB->GetID(), actorA, actorA->GetID(), point, normal, relativeVelocity });
+}
+
+// Actor ids are never reused, so a matching id and pointer means the actor is still live
+static bool isLive(Actor* actor, int actorId) {
+    return ActorRegistry::Get(ActorRegistry::HandleOf(actorId)) == actor;
+}
+
+void CollisionEvents::Dispatch() {
+    if (events.empty()) {
+        return;
+    }
+    ProfileScope scope("Collision dispatch");
+
+    // Handlers may cause new contacts to be recorded; those wait for the next dispatch
+    dispatchingEvents.swap(events);
+
+    ComponentDispatch::BeginCollisionDispatch();
+    Collision collision;
+    for (const CollisionEvent& event : dispatchingEvents) {
+        if (!isLive(event.actor, event.actorId)) {
+            continue;
+        }
+
+        collision.other = isLive(event.other, event.otherId) ? event.other : nullptr;
+        collision.point = event.point;
+        collision.normal = event.normal;
+        collision.relative_velocity = event.relativeVelocity;
+        ComponentDispatch::RunCollisionHandlers(event.phase, event.actor, collision);
+    }
+    ComponentDispatch::EndCollisionDispatch();
+
+    dispatchingEvents.clear();
+}
+
+void CollisionEvents::Clear() {
+    events.clear();
+}
@@ -0,0 +1,137 @@
+#include "headers/CollisionFilters.h"
+#include "headers/EngineUtils.h"
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+extern std::string gamePlaying;
+
+std::unordered_map<const RigidBody*, CollisionFilters::Settings> CollisionFilters::settings;
+std::vector<std::string> CollisionFilters::layerNames;
+std::string CollisionFilters::layersForGame;
+
+void CollisionFilters::loadLayers() {
+    if (!layerNames.empty() && layersForGame == gamePlaying) {
+        return;
+    }
+    layersForGame = gamePlaying;
+    layerNames.assign(1, "Default");
+
+    const std::filesystem::path configFile{ "resources/" + gamePlaying + "/game.config" };
+    if (!std::filesystem::exists(configFile)) {
+        return;
+    }
+
+    rapidjson::Document gameConfig;
+    EngineUtils::ReadJsonFile(configFile.string(), gameConfig);
+    if (!gameConfig.HasMember("collision_layers") || !gameConfig["collision_layers"].IsArray()) {
+        return;
+    }
+
+    for (const auto& layer : gameConfig["collision_layers"].GetArray()) {
+        if (!layer.IsString() || std::string(layer.GetString()) == "Default") {
+            continue;
+        }
+        if (layerNames.size() == 16) {
+            std::cout << "error: more than 16 collision layers";
+            exit(0);
+        }
+        layerNames.push_back(layer.GetString());
+    }
+}
+
+uint16 CollisionFilters::layerBit(const std::string& name) {
+    for (size_t i = 0; i < layerNames.size(); ++i) {
+        if (layerNames[i] == name) {
+            return static_cast<uint16>(1u << i);
+        }
+    }
+    std::cout << "error: collision layer " << name << " is not in collision_layers";
+    exit(0);
+}
+
+uint16 CollisionFilters::maskFor(const std::string& layers) {
+    if (layers == "all") return 0xFFFF;
+    if (layers == "none") return 0;
+
+    uint16 mask = 0;
+    std::stringstream list(layers);
+    std::string name;
+    while (std::getline(list, name, ',')) {
+        // Allow "Enemy, Wall"
+        name.erase(0, name.find_first_not_of(' '));
+        name.erase(name.find_last_not_of(' ') + 1);
+        if (!name.empty()) {
+            mask |= layerBit(name);
+        }
+    }
+    return mask;
+}
+
+b2Filter CollisionFilters::FilterFor(const RigidBody* body) {
+    b2Filter filter;
+    auto it = settings.find(body);
+    if (it == settings.end()) {
+        return filter; // Box2D defaults: layer 0, collides with everything
+    }
+
+    loadLayers();
+    filter.categoryBits = layerBit(it->second.layer);
+    filter.maskBits = maskFor(it->second.collidesWith);
+    filter.groupIndex = static_cast<int16>(it->second.group);
+    return filter;
+}
+
+void CollisionFilters::CopySettings(const RigidBody* from, const RigidBody* to) {
+    auto it = settings.find(from);
+    if (it != settings.end()) {
+        settings[to] = it->second;
+    }
+    else {
+        settings.erase(to);
+    }
+}
+
+void CollisionFilters::refresh(RigidBody* body) {
+    if (!body->m_body) {
+        return;
+    }
+
+    b2Filter filter = FilterFor(body);
+    for (b2Fixture* fixture = body->m_body->GetFixtureList(); fixture; fixture = fixture->GetNext()) {
+        // The phantom sensor has no actor and never collides with anything
+        if (fixture->GetUserData().pointer) {
+            fixture->SetFilterData(filter);
+        }
+    }
+}
+
+std::string CollisionFilters::GetLayer(const RigidBody* body) {
+    auto it = settings.find(body);
+    return it == settings.end() ? "Default" : it->second.layer;
+}
+
+void CollisionFilters::SetLayer(RigidBody* body, std::string layer) {
+    settings[body].layer = layer;
+    refresh(body);
+}
+
+std::string CollisionFilters::GetCollidesWith(const RigidBody* body) {
+    auto it = settings.find(body);
+    return it == settings.end() ? "all" : it->second.collidesWith;
+}
+
+void CollisionFilters::SetCollidesWith(RigidBody* body, std::string layers) {
+    settings[body].collidesWith = layers;
+    refresh(body);
+}
+
+int CollisionFilters::GetGroup(const RigidBody* body) {
+    auto it = settings.find(body);
+    return it == settings.end() ? 0 : it->second.group;
+}
+
+void CollisionFilters::SetGroup(RigidBody* body, int group) {
+    settings[body].group = group;
+    refresh(body);
+}
@@ -0,0 +1,395 @@
+#include "headers/ComponentDispatch.h"
+#include "headers/MainHelper.h"
+#include "headers/Profiler.h"
+#include "headers/ActivityManager.h"
+#include "headers/ActorRegistry.h"
+#include <algorithm>
+#include <cstring>
+
+std::vector<LifecycleEntry> ComponentDispatch::pendingStart;
+std::vector<LifecycleEntry> ComponentDispatch::onUpdate;
+std::vector<LifecycleEntry> ComponentDispatch::onLateUpdate;
+std::vector<LifecycleEntry> ComponentDispatch::collisionHandlers[static_cast<int>(CollisionPhase::Count)];
+std::vector<std::tuple<Actor*, std::string, std::shared_ptr<luabridge::LuaRef>>> ComponentDispatch::deferredRegistrations;
+bool ComponentDispatch::dispatching = false;
+bool ComponentDispatch::hasRemovals = false;
+
+extern void ReportError(const std::string& actor_name, const luabridge::LuaException& e);
+
+static const char* const kCollisionFunctions[] = { "OnCollisionEnter", "OnCollisionExit", "OnTriggerEnter", "OnTriggerExit" };
+
+// Assignments the __newindex hook routes through ComponentDispatch::functionAssigned
+static const char* const kWatchedFunctions[] = { "OnUpdate", "OnLateUpdate", "OnCollisionEnter", "OnCollisionExit", "OnTriggerEnter", "OnTriggerExit" };
+
+static bool entryLess(const LifecycleEntry& entry, const std::pair<int, const std::string*>& target) {
+    if (entry.actorId != target.first) return entry.actorId < target.first;
+    return entry.key < *target.second;
+}
+
+void ComponentDispatch::insertEntry(std::vector<LifecycleEntry>& list, LifecycleEntry entry) {
+    // New actors always carry the highest id, so the common case is an append.
+    if (list.empty() || entryLess(list.back(), { entry.actorId, &entry.key })) {
+        list.push_back(std::move(entry));
+        return;
+    }
+
+    auto it = std::lower_bound(list.begin(), list.end(), std::make_pair(entry.actorId, &entry.key), entryLess);
+    if (it != list.end() && !it->removed && it->actorId == entry.actorId && it->key == entry.key) {
+        return; // Already registered
+    }
+    list.insert(it, std::move(entry));
+}
+
+void ComponentDispatch::RegisterComponent(Actor* actor, const std::string& key, const std::shared_ptr<luabridge::LuaRef>& component) {
+    if (dispatching) {
+        deferredRegistrations.emplace_back(actor, key, component);
+        return;
+    }
+
+    luabridge::LuaRef& ref = *component;
+    std::string type = ref["type"].isString() ? ref["type"].cast<std::string>() : "";
+
+    if (!ref["OnStartOver"].cast<bool>()) {
+        luabridge::LuaRef onStart = ref["OnStart"];
+        if (onStart.isFunction()) {
+            insertEntry(pendingStart, { actor, actor->GetID(), key, type, component, onStart, false });
+        }
+    }
+
+    luabridge::LuaRef onUpdateFn = ref["OnUpdate"];
+    if (onUpdateFn.isFunction()) {
+        insertEntry(onUpdate, { actor, actor->GetID(), key, type, component, onUpdateFn, false });
+    }
+
+    luabridge::LuaRef onLateUpdateFn = ref["OnLateUpdate"];
+    if (onLateUpdateFn.isFunction()) {
+        insertEntry(onLateUpdate, { actor, actor->GetID(), key, type, component, onLateUpdateFn, false });
+    }
+
+    // Contacts have only ever been delivered to CollisionResponder components
+    if (type == "CollisionResponder") {
+        for (int phase = 0; phase < static_cast<int>(CollisionPhase::Count); ++phase) {
+            luabridge::LuaRef handler = ref[kCollisionFunctions[phase]];
+            if (handler.isFunction()) {
+                insertEntry(collisionHandlers[phase], { actor, actor->GetID(), key, type, component, handler, false });
+            }
+        }
+    }
+
+    if (ref.isTable()) {
+        watchAssignments(actor->GetID(), key, ref);
+    }
+}
+
+std::vector<LifecycleEntry>* ComponentDispatch::listFor(const std::string& name, const std::string& type) {
+    if (name == "OnUpdate") return &onUpdate;
+    if (name == "OnLateUpdate") return &onLateUpdate;
+    if (type == "CollisionResponder") {
+        for (int phase = 0; phase < static_cast<int>(CollisionPhase::Count); ++phase) {
+            if (name == kCollisionFunctions[phase]) return &collisionHandlers[phase];
+        }
+    }
+    return nullptr;
+}
+
+// Stack while it runs: instance, its metatable, then the table assigned functions go in
+void ComponentDispatch::watchAssignments(int actorId, const std::string& key, const luabridge::LuaRef& component) {
+    lua_State* L = LuaHelper::L;
+    component.push(L);
+    if (!lua_getmetatable(L, -1)) {
+        lua_pop(L, 1);
+        return; // LuaHelper::EstablishInheritance gives every instance one
+    }
+
+    lua_getfield(L, -1, "__newindex");
+    if (lua_tocfunction(L, -1) == &ComponentDispatch::onComponentWrite) {
+        // Watched already (a pooled instance again); only the actor id changes
+        lua_getupvalue(L, -1, 1);
+        lua_remove(L, -2);
+    }
+    else {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_newtable(L);
+        lua_getfield(L, -3, "__index");
+        lua_setfield(L, -2, "__index");
+        lua_setmetatable(L, -2);
+        lua_pushvalue(L, -1);
+        lua_setfield(L, -3, "__index");
+
+        // Functions already set on the instance itself move over, or replacing them would go unseen
+        for (const char* name : kWatchedFunctions) {
+            lua_pushstring(L, name);
+            if (lua_rawget(L, -4) == LUA_TNIL) {
+                lua_pop(L, 1);
+                continue;
+            }
+            lua_setfield(L, -2, name);
+            lua_pushnil(L);
+            lua_setfield(L, -4, name);
+        }
+    }
+    lua_pushinteger(L, actorId);
+    lua_pushstring(L, key.c_str());
+    lua_pushcclosure(L, &ComponentDispatch::onComponentWrite, 3);
+    lua_setfield(L, -2, "__newindex");
+    lua_pop(L, 2);
+}
+
+// __newindex of a watched component: (instance, name, value), upvalues (assigned functions, actor id, key).
+// Only fires for names the instance does not hold itself, which watched functions never are.
+int ComponentDispatch::onComponentWrite(lua_State* L) {
+    if (lua_type(L, 2) == LUA_TSTRING) {
+        const char* name = lua_tostring(L, 2);
+        for (const char* watched : kWatchedFunctions) {
+            if (std::strcmp(name, watched) != 0) continue;
+
+            lua_pushvalue(L, 2);
+            lua_pushvalue(L, 3);
+            lua_rawset(L, lua_upvalueindex(1));
+            std::string key = lua_tostring(L, lua_upvalueindex(3));
+            functionAssigned(static_cast<int>(lua_tointeger(L, lua_upvalueindex(2))), key, name, luabridge::LuaRef::fromStack(L, 3));
+            return 0;
+        }
+    }
+    lua_settop(L, 3);
+    lua_rawset(L, 1);
+    return 0;
+}
+
+void ComponentDispatch::functionAssigned(int actorId, const std::string& key, const std::string& name, const luabridge::LuaRef& function) {
+    std::shared_ptr<Actor> actor = ActorRegistry::GetShared(actorId);
+    if (!actor) {
+        return; // Not live yet; RegisterComponent looks the function up when it is
+    }
+    auto component = actor->actor_components.find(key);
+    if (component == actor->actor_components.end()) {
+        return;
+    }
+    luabridge::LuaRef& ref = *component->second;
+    std::string type = ref["type"].isString() ? ref["type"].cast<std::string>() : "";
+    std::vector<LifecycleEntry>* list = listFor(name, type);
+    if (!list) {
+        return;
+    }
+
+    auto it = std::lower_bound(list->begin(), list->end(), std::make_pair(actorId, &key), entryLess);
+    for (; it != list->end() && it->actorId == actorId && it->key == key; ++it) {
+        if (it->removed) continue;
+        if (function.isFunction()) {
+            it->function = function; // a running call keeps the old function on the Lua stack
+        }
+        else {
+            it->removed = true;
+            hasRemovals = true;
+        }
+        return;
+    }
+
+    if (!function.isFunction()) {
+        return;
+    }
+    if (dispatching) {
+        deferredRegistrations.emplace_back(actor.get(), key, component->second);
+        return;
+    }
+    insertEntry(*list, { actor.get(), actorId, key, type, component->second, function, false });
+}
+
+void ComponentDispatch::ForgetAssignedFunctions(const luabridge::LuaRef& component) {
+    lua_State* L = LuaHelper::L;
+    component.push(L);
+    if (lua_getmetatable(L, -1)) {
+        lua_getfield(L, -1, "__newindex");
+        if (lua_tocfunction(L, -1) == &ComponentDispatch::onComponentWrite) {
+            lua_getupvalue(L, -1, 1);
+            for (const char* name : kWatchedFunctions) {
+                lua_pushnil(L);
+                lua_setfield(L, -2, name);
+            }
+            lua_pop(L, 1);
+        }
+        lua_pop(L, 2);
+    }
+    lua_pop(L, 1);
+}
+
+void ComponentDispatch::RegisterActor(Actor* actor) {
+    for (const auto& [key, componentRef] : actor->actor_components) {
+        RegisterComponent(actor, key, componentRef);
+    }
+}
+
+void ComponentDispatch::markRemoved(std::vector<LifecycleEntry>& list, int actorId, const std::string* key) {
+    static const std::string firstKey;
+    auto it = std::lower_bound(list.begin(), list.end(), std::make_pair(actorId, key ? key : &firstKey), entryLess);
+    for (; it != list.end() && it->actorId == actorId; ++it) {
+        if (key && it->key != *key) break;
+        it->removed = true;
+        hasRemovals = true;
+    }
+}
+
+void ComponentDispatch::UnregisterComponent(Actor* actor, const std::string& key) {
+    markRemoved(pendingStart, actor->GetID(), &key);
+    markRemoved(onUpdate, actor->GetID(), &key);
+    markRemoved(onLateUpdate, actor->GetID(), &key);
+    for (auto& handlers : collisionHandlers) {
+        markRemoved(handlers, actor->GetID(), &key);
+    }
+}
+
+void ComponentDispatch::UnregisterActor(Actor* actor) {
+    markRemoved(pendingStart, actor->GetID(), nullptr);
+    markRemoved(onUpdate, actor->GetID(), nullptr);
+    markRemoved(onLateUpdate, actor->GetID(), nullptr);
+    for (auto& handlers : collisionHandlers) {
+        markRemoved(handlers, actor->GetID(), nullptr);
+    }
+
+    deferredRegistrations.erase(std::remove_if(deferredRegistrations.begin(), deferredRegistrations.end(),
+        [actor](const auto& pending) { return std::get<0>(pending) == actor; }), deferredRegistrations.end());
+}
+
+void ComponentDispatch::Clear() {
+    pendingStart.clear();
+    onUpdate.clear();
+    onLateUpdate.clear();
+    for (auto& handlers : collisionHandlers) {
+        handlers.clear();
+    }
+    deferredRegistrations.clear();
+    hasRemovals = false;
+}
+
+void ComponentDispatch::compact(std::vector<LifecycleEntry>& list) {
+    list.erase(std::remove_if(list.begin(), list.end(),
+        [](const LifecycleEntry& entry) { return entry.removed; }), list.end());
+}
+
+void ComponentDispatch::flushDeferredRegistrations() {
+    if (hasRemovals) {
+        compact(pendingStart);
+        compact(onUpdate);
+        compact(onLateUpdate);
+        for (auto& handlers : collisionHandlers) {
+            compact(handlers);
+        }
+        hasRemovals = false;
+    }
+
+    std::vector<std::tuple<Actor*, std::string, std::shared_ptr<luabridge::LuaRef>>> pending;
+    pending.swap(deferredRegistrations);
+    for (auto& [actor, key, component] : pending) {
+        RegisterComponent(actor, key, component);
+    }
+}
+
+void ComponentDispatch::RunOnStart() {
+    ProfileScope scope("OnStart pass");
+    flushDeferredRegistrations();
+
+    dispatching = true;
+    for (auto& entry : pendingStart) {
+        if (entry.removed) continue;
+        luabridge::LuaRef& component = *entry.component;
+        try {
+            // Disabled components keep waiting for their OnStart until they are enabled.
+            if (!component["enabled"].cast<bool>()) continue;
+
+            int64_t callStart = Profiler::enabled ? Profiler::NowMicros() : 0;
+            entry.function(component);
+            component["OnStartOver"] = true;
+            if (Profiler::enabled) {
+                Profiler::RecordComponentCall("OnStart", entry.type, entry.actor->actor_name, callStart);
+            }
+        }
+        catch (const luabridge::LuaException& e) {
+            ReportError(entry.actor->actor_name, e);
+            component["OnStartOver"] = true;
+        }
+        entry.removed = true;
+        hasRemovals = true;
+    }
+    dispatching = false;
+
+    compact(pendingStart);
+    flushDeferredRegistrations();
+}
+
+// skipIds is sorted, like list, so dormant actors are skipped in one merged walk
+static void runPhase(std::vector<LifecycleEntry>& list, const char* phase, const std::vector<int>& skipIds) {
+    auto skip = skipIds.begin();
+    for (auto& entry : list) {
+        if (entry.removed) continue;
+        while (skip != skipIds.end() && *skip < entry.actorId) ++skip;
+        if (skip != skipIds.end() && *skip == entry.actorId) continue;
+        luabridge::LuaRef& component = *entry.component;
+        try {
+            if (!component["enabled"].cast<bool>()) continue;
+
+            int64_t callStart = Profiler::enabled ? Profiler::NowMicros() : 0;
+            entry.function(component);
+            if (Profiler::enabled) {
+                Profiler::RecordComponentCall(phase, entry.type, entry.actor->actor_name, callStart);
+            }
+        }
+        catch (const luabridge::LuaException& e) {
+            ReportError(entry.actor->actor_name, e);
+        }
+    }
+}
+
+void ComponentDispatch::RunOnUpdate() {
+    ProfileScope scope("OnUpdate pass");
+    flushDeferredRegistrations();
+
+    dispatching = true;
+    runPhase(onUpdate, "OnUpdate", ActivityManager::DormantIds());
+    dispatching = false;
+
+    flushDeferredRegistrations();
+}
+
+void ComponentDispatch::RunOnLateUpdate() {
+    ProfileScope scope("OnLateUpdate pass");
+    flushDeferredRegistrations();
+
+    dispatching = true;
+    runPhase(onLateUpdate, "OnLateUpdate", ActivityManager::DormantIds());
+    dispatching = false;
+
+    flushDeferredRegistrations();
+}
+
+void ComponentDispatch::BeginCollisionDispatch() {
+    flushDeferredRegistrations();
+    dispatching = true;
+}
+
+void ComponentDispatch::EndCollisionDispatch() {
+    dispatching = false;
+    flushDeferredRegistrations();
+}
+
+void ComponentDispatch::RunCollisionHandlers(CollisionPhase phase, Actor* actor, const Collision& collision) {
+    static const std::string firstKey;
+    std::vector<LifecycleEntry>& handlers = collisionHandlers[static_cast<int>(phase)];
+    const char* functionName = kCollisionFunctions[static_cast<int>(phase)];
+
+    int actorId = actor->GetID();
+    auto it = std::lower_bound(handlers.begin(), handlers.end(), std::make_pair(actorId, &firstKey), entryLess);
+    for (; it != handlers.end() && it->actorId == actorId; ++it) {
+        if (it->removed) continue;
+        try {
+            int64_t callStart = Profiler::enabled ? Profiler::NowMicros() : 0;
+            it->function(*it->component, collision);
+            if (Profiler::enabled) {
+                Profiler::RecordComponentCall(functionName, it->type, actor->actor_name, callStart);
+            }
+        }
+        catch (const luabridge::LuaException& e) {
+            ReportError(actor->actor_name, e);
+        }
+    }
+}
@@ -0,0 +1,377 @@
+#include "headers/CookedAsset.h"
+#define _SILENCE_EXPERIMENTAL_FILESYSTEM_DEPRECATION_WARNING
+#include <filesystem>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+#include "rapidjson/document.h"
+#include "rapidjson/filereadstream.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+CookedAsset::~CookedAsset() {
+    unmap();
+}
+
+std::string CookedAsset::CookedPath(const std::string& sourcePath) {
+    return sourcePath + ".cooked";
+}
+
+bool CookedAsset::Open(const std::string& sourcePath) {
+    unmap();
+
+    std::error_code error;
+    std::filesystem::path cookedPath{ CookedPath(sourcePath) };
+    auto cookedTime = std::filesystem::last_write_time(cookedPath, error);
+    if (error) {
+        return false;
+    }
+    auto sourceTime = std::filesystem::last_write_time(std::filesystem::path{ sourcePath }, error);
+    if (!error && sourceTime > cookedTime) {
+        return false; // stale, the JSON has been edited since
+    }
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(cookedPath.string().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = open(cookedPath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped != MAP_FAILED) {
+        data = static_cast<const unsigned char*>(mapped);
+        size = static_cast<size_t>(info.st_size);
+    }
+#endif
+
+    if (!data || !validate()) {
+        std::cout << "warning: ignoring unreadable cooked file " << cookedPath.string() << std::endl;
+        unmap();
+        return false;
+    }
+    return true;
+}
+
+bool CookedAsset::validate() {
+    if (size < sizeof(Cooked::Header)) {
+        return false;
+    }
+    const auto* head = reinterpret_cast<const Cooked::Header*>(data);
+    if (head->magic != Cooked::kMagic || head->version != Cooked::kVersion) {
+        return false;
+    }
+
+    uint64_t expected = sizeof(Cooked::Header)
+        + uint64_t(head->stringCount) * sizeof(uint32_t)
+        + head->stringBytes
+        + uint64_t(head->actorCount) * sizeof(Cooked::Actor)
+        + uint64_t(head->componentCount) * sizeof(Cooked::Component)
+        + uint64_t(head->propertyCount) * sizeof(Cooked::Property);
+    if (expected != size || head->stringBytes % 4 != 0) {
+        return false;
+    }
+
+    const unsigned char* cursor = data + sizeof(Cooked::Header);
+    header = head;
+    stringOffsets = reinterpret_cast<const uint32_t*>(cursor);
+    cursor += head->stringCount * sizeof(uint32_t);
+    strings = reinterpret_cast<const char*>(cursor);
+    cursor += head->stringBytes;
+    actors = reinterpret_cast<const Cooked::Actor*>(cursor);
+    cursor += head->actorCount * sizeof(Cooked::Actor);
+    components = reinterpret_cast<const Cooked::Component*>(cursor);
+    cursor += head->componentCount * sizeof(Cooked::Component);
+    properties = reinterpret_cast<const Cooked::Property*>(cursor);
+
+    // Bounds-check every index once so the loaders can read without checks
+    if (head->stringBytes > 0 && strings[head->stringBytes - 1] != '\0') {
+        return false;
+    }
+    for (uint32_t i = 0; i < head->stringCount; ++i) {
+        if (stringOffsets[i] >= head->stringBytes) {
+            return false;
+        }
+    }
+    auto validString = [head](uint32_t index, bool optional) {
+        return index < head->stringCount || (optional && index == Cooked::kNone);
+    };
+    for (uint32_t i = 0; i < head->actorCount; ++i) {
+        const Cooked::Actor& actor = actors[i];
+        if (!validString(actor.name, true) || !validString(actor.templateName, true)
+            || uint64_t(actor.firstComponent) + actor.componentCount > head->componentCount) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < head->componentCount; ++i) {
+        const Cooked::Component& component = components[i];
+        if (!validString(component.key, false) || !validString(component.type, true)
+            || uint64_t(component.firstProperty) + component.propertyCount > head->propertyCount) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < head->propertyCount; ++i) {
+        const Cooked::Property& property = properties[i];
+        if (!validString(property.name, false) || property.kind > Cooked::PropertyKind::Bool
+            || (property.kind == Cooked::PropertyKind::String && !validString(property.string, false))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CookedAsset::unmap() {
+#ifdef _WIN32
+    if (data && owned.empty()) {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle) {
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+    }
+    if (fileHandle) {
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+    }
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#else
+    if (data && owned.empty()) {
+        munmap(const_cast<unsigned char*>(data), size);
+    }
+#endif
+    owned.clear();
+    data = nullptr;
+    size = 0;
+    header = nullptr;
+}
+
+namespace {
+    // Accumulates the sections of one cooked file
+    struct CookWriter {
+        std::vector<uint32_t> stringOffsets;
+        std::vector<char> stringBytes;
+        std::unordered_map<std::string, uint32_t> stringIds;
+        std::vector<Cooked::Actor> actors;
+        std::vector<Cooked::Component> components;
+        std::vector<Cooked::Property> properties;
+
+        uint32_t intern(const std::string& value) {
+            auto it = stringIds.find(value);
+            if (it != stringIds.end()) {
+                return it->second;
+            }
+            uint32_t id = static_cast<uint32_t>(stringOffsets.size());
+            stringOffsets.push_back(static_cast<uint32_t>(stringBytes.size()));
+            stringBytes.insert(stringBytes.end(), value.begin(), value.end());
+            stringBytes.push_back('\0');
+            stringIds.emplace(value, id);
+            return id;
+        }
+
+        // Same value types, in the same order of precedence, as the JSON loaders
+        void addComponents(const rapidjson::Value& componentsValue, Cooked::Actor& actor) {
+            actor.firstComponent = static_cast<uint32_t>(components.size());
+            actor.componentCount = 0;
+            if (!componentsValue.IsObject()) {
+                return;
+            }
+            for (const auto& member : componentsValue.GetObject()) {
+                if (!member.value.IsObject()) {
+                    continue;
+                }
+                Cooked::Component component;
+                component.key = intern(member.name.GetString());
+                component.type = member.value.HasMember("type") && member.value["type"].IsString()
+                    ? intern(member.value["type"].GetString()) : Cooked::kNone;
+                component.firstProperty = static_cast<uint32_t>(properties.size());
+                for (auto it = member.value.MemberBegin(); it != member.value.MemberEnd(); ++it) {
+                    Cooked::Property property;
+                    property.name = intern(it->name.GetString());
+                    if (it->value.IsString()) {
+                        property.kind = Cooked::PropertyKind::String;
+                        property.string = intern(it->value.GetString());
+                    }
+                    else if (it->value.IsInt()) {
+                        property.kind = Cooked::PropertyKind::Int;
+                        property.intValue = it->value.GetInt();
+                    }
+                    else if (it->value.IsFloat()) {
+                        property.kind = Cooked::PropertyKind::Float;
+                        property.floatValue = it->value.GetFloat();
+                    }
+                    else if (it->value.IsBool()) {
+                        property.kind = Cooked::PropertyKind::Bool;
+                        property.boolValue = it->value.GetBool() ? 1 : 0;
+                    }
+                    else {
+                        continue;
+                    }
+                    properties.push_back(property);
+                }
+                component.propertyCount = static_cast<uint32_t>(properties.size()) - component.firstProperty;
+                components.push_back(component);
+                actor.componentCount++;
+            }
+        }
+    };
+}
+
+bool CookedAsset::Load(const std::string& sourcePath) {
+    if (Open(sourcePath)) {
+        return true;
+    }
+    if (!compile(sourcePath, owned)) {
+        return false;
+    }
+    data = owned.data();
+    size = owned.size();
+    if (!validate()) {
+        unmap();
+        return false;
+    }
+    return true;
+}
+
+bool CookedAsset::Cook(const std::string& sourcePath) {
+    std::vector<unsigned char> image;
+    if (!compile(sourcePath, image)) {
+        return false;
+    }
+
+    std::string outPath = CookedPath(sourcePath);
+    FILE* out = nullptr;
+#ifdef _WIN32
+    fopen_s(&out, outPath.c_str(), "wb");
+#else
+    out = fopen(outPath.c_str(), "wb");
+#endif
+    if (!out) {
+        std::cout << "error: cannot write " << outPath << std::endl;
+        return false;
+    }
+    std::fwrite(image.data(), 1, image.size(), out);
+    std::fclose(out);
+    return true;
+}
+
+bool CookedAsset::compile(const std::string& sourcePath, std::vector<unsigned char>& image) {
+    FILE* file_pointer = nullptr;
+#ifdef _WIN32
+    fopen_s(&file_pointer, sourcePath.c_str(), "rb");
+#else
+    file_pointer = fopen(sourcePath.c_str(), "rb");
+#endif
+    if (!file_pointer) {
+        std::cout << "error: cannot open " << sourcePath << std::endl;
+        return false;
+    }
+    char buffer[65536];
+    rapidjson::FileReadStream stream(file_pointer, buffer, sizeof(buffer));
+    rapidjson::Document document;
+    document.ParseStream(stream);
+    std::fclose(file_pointer);
+    if (document.HasParseError() || !document.IsObject()) {
+        std::cout << "error parsing json at [" << sourcePath << "]" << std::endl;
+        return false;
+    }
+
+    CookWriter writer;
+    Cooked::Header header{};
+    header.magic = Cooked::kMagic;
+    header.version = Cooked::kVersion;
+    header.poolPrewarm = -1;
+    header.poolMax = 0;
+
+    bool isTemplate = std::filesystem::path{ sourcePath }.extension() == ".template";
+    if (isTemplate) {
+        Cooked::Actor actor;
+        actor.name = writer.intern(document.HasMember("name") && document["name"].IsString() ? document["name"].GetString() : "");
+        actor.templateName = Cooked::kNone;
+        if (document.HasMember("components")) {
+            writer.addComponents(document["components"], actor);
+        }
+        else {
+            actor.firstComponent = 0;
+            actor.componentCount = 0;
+        }
+        writer.actors.push_back(actor);
+
+        if (document.HasMember("pool") && document["pool"].IsObject()) {
+            const auto& pool = document["pool"];
+            header.poolPrewarm = pool.HasMember("prewarm") && pool["prewarm"].IsInt() ? pool["prewarm"].GetInt() : 0;
+            header.poolMax = pool.HasMember("max") && pool["max"].IsInt() ? pool["max"].GetInt() : 0;
+        }
+    }
+    else {
+        if (!document.HasMember("actors") || !document["actors"].IsArray()) {
+            std::cout << "error: " << sourcePath << " has no actors array" << std::endl;
+            return false;
+        }
+        for (const auto& actorValue : document["actors"].GetArray()) {
+            Cooked::Actor actor;
+            actor.templateName = actorValue.HasMember("template") ? writer.intern(actorValue["template"].GetString()) : Cooked::kNone;
+            actor.name = actorValue.HasMember("name") ? writer.intern(actorValue["name"].GetString()) : Cooked::kNone;
+            actor.firstComponent = static_cast<uint32_t>(writer.components.size());
+            actor.componentCount = 0;
+            if (actorValue.HasMember("components")) {
+                writer.addComponents(actorValue["components"], actor);
+            }
+            writer.actors.push_back(actor);
+        }
+    }
+
+    while (writer.stringBytes.size() % 4 != 0) {
+        writer.stringBytes.push_back('\0');
+    }
+    header.stringCount = static_cast<uint32_t>(writer.stringOffsets.size());
+    header.stringBytes = static_cast<uint32_t>(writer.stringBytes.size());
+    header.actorCount = static_cast<uint32_t>(writer.actors.size());
+    header.componentCount = static_cast<uint32_t>(writer.components.size());
+    header.propertyCount = static_cast<uint32_t>(writer.properties.size());
+
+    image.clear();
+    auto append = [&image](const void* bytes, size_t count) {
+        const unsigned char* begin = static_cast<const unsigned char*>(bytes);
+        image.insert(image.end(), begin, begin + count);
+    };
+    append(&header, sizeof(header));
+    append(writer.stringOffsets.data(), writer.stringOffsets.size() * sizeof(uint32_t));
+    append(writer.stringBytes.data(), writer.stringBytes.size());
+    append(writer.actors.data(), writer.actors.size() * sizeof(Cooked::Actor));
+    append(writer.components.data(), writer.components.size() * sizeof(Cooked::Component));
+    append(writer.properties.data(), writer.properties.size() * sizeof(Cooked::Property));
+    return true;
+}
@@ -1,4 +1,5 @@
 #include "headers/Eventbus.h"
+#include "headers/Profiler.h"
 #include <algorithm>
 #include <iostream>
 
@@ -28,6 +29,7 @@ void EventBus::Unsubscribe(const std::string& event_type, luabridge::LuaRef comp
 }
 
 void EventBus::ProcessSubscriptions() {
+    ProfileScope scope("EventBus::ProcessSubscriptions");
     // Apply subscriptions
     for (auto& [event_type, component, function] : pendingSubscriptions) {
         subscriptions[event_type].emplace_back(component, function);
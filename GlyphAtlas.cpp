@@ -0,0 +1,112 @@
+#include "headers/GlyphAtlas.h"
+#include "headers/SpriteBatch.h"
+#include <algorithm>
+
+bool GlyphAtlas::enabled = false;
+std::unordered_map<TTF_Font*, GlyphAtlas::FontAtlas> GlyphAtlas::atlases;
+
+GlyphAtlas::FontAtlas* GlyphAtlas::atlasFor(SDL_Renderer* renderer, TTF_Font* font) {
+    auto found = atlases.find(font);
+    if (found != atlases.end()) {
+        return found->second.texture ? &found->second : nullptr;
+    }
+
+    FontAtlas& atlas = atlases[font];
+    atlas.texture = nullptr;
+    atlas.glyphs.resize(kLastGlyph - kFirstGlyph + 1);
+
+    // Rasterize every glyph white; colour comes from the vertices
+    SDL_Color white = { 255, 255, 255, 255 };
+    std::vector<SDL_Surface*> surfaces(atlas.glyphs.size(), nullptr);
+    int cursorX = 0, cursorY = 0, shelfHeight = 0;
+
+    for (int ch = kFirstGlyph; ch <= kLastGlyph; ++ch) {
+        Glyph& glyph = atlas.glyphs[ch - kFirstGlyph];
+        glyph.rect = { 0, 0, 0, 0 };
+        glyph.advance = 0;
+
+        int minX, maxX, minY, maxY;
+        if (TTF_GlyphMetrics(font, static_cast<Uint16>(ch), &minX, &maxX, &minY, &maxY, &glyph.advance) != 0) {
+            continue;
+        }
+
+        SDL_Surface* surface = TTF_RenderGlyph_Blended(font, static_cast<Uint16>(ch), white);
+        if (!surface) {
+            continue; // e.g. space: nothing to draw, only the advance
+        }
+        surfaces[ch - kFirstGlyph] = surface;
+
+        if (cursorX + surface->w + 1 > kAtlasWidth) {
+            cursorX = 0;
+            cursorY += shelfHeight;
+            shelfHeight = 0;
+        }
+        glyph.rect = { cursorX, cursorY, surface->w, surface->h };
+        cursorX += surface->w + 1;
+        shelfHeight = std::max(shelfHeight, surface->h + 1);
+    }
+
+    atlas.width = kAtlasWidth;
+    atlas.height = std::max(1, cursorY + shelfHeight);
+    SDL_Surface* page = SDL_CreateRGBSurfaceWithFormat(0, atlas.width, atlas.height, 32, SDL_PIXELFORMAT_RGBA32);
+    if (page) {
+        SDL_FillRect(page, NULL, 0);
+        for (size_t i = 0; i < surfaces.size(); ++i) {
+            if (!surfaces[i]) continue;
+            SDL_Rect destRect = atlas.glyphs[i].rect;
+            SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(surfaces[i], NULL, page, &destRect);
+        }
+        atlas.texture = SDL_CreateTextureFromSurface(renderer, page);
+        if (atlas.texture) {
+            SDL_SetTextureBlendMode(atlas.texture, SDL_BLENDMODE_BLEND);
+        }
+        SDL_FreeSurface(page);
+    }
+
+    for (SDL_Surface* surface : surfaces) {
+        if (surface) SDL_FreeSurface(surface);
+    }
+    return atlas.texture ? &atlas : nullptr;
+}
+
+bool GlyphAtlas::Draw(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, SDL_Color color, int x, int y) {
+    for (char c : text) {
+        unsigned char ch = static_cast<unsigned char>(c);
+        if (ch < kFirstGlyph || ch > kLastGlyph) {
+            return false;
+        }
+    }
+
+    FontAtlas* atlas = atlasFor(renderer, font);
+    if (!atlas) {
+        return false;
+    }
+
+    int penX = x;
+    int previous = 0;
+    for (char c : text) {
+        int ch = static_cast<unsigned char>(c);
+        const Glyph& glyph = atlas->glyphs[ch - kFirstGlyph];
+
+        if (previous) {
+            penX += TTF_GetFontKerningSizeGlyphs(font, static_cast<Uint16>(previous), static_cast<Uint16>(ch));
+        }
+        if (glyph.rect.w > 0) {
+            SDL_Rect destRect = { penX, y, glyph.rect.w, glyph.rect.h };
+            SpriteBatch::Add(renderer, atlas->texture, &glyph.rect, atlas->width, atlas->height, destRect, { 0.0f, 0.0f }, 0.0f, 1.0f, color);
+        }
+        penX += glyph.advance;
+        previous = ch;
+    }
+    return true;
+}
+
+void GlyphAtlas::Clear() {
+    for (auto& [font, atlas] : atlases) {
+        if (atlas.texture) {
+            SDL_DestroyTexture(atlas.texture);
+        }
+    }
+    atlases.clear();
+}
@@ -0,0 +1,46 @@
+#include "headers/Headless.h"
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+uint64_t Headless::imageCommands = 0;
+uint64_t Headless::textCommands = 0;
+
+int Headless::ParseFrameCount(int argc, char* argv[], int defaultFrames) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--frames") {
+            int frames = std::atoi(argv[i + 1]);
+            if (frames > 0) {
+                return frames;
+            }
+        }
+    }
+    return defaultFrames;
+}
+
+std::string Headless::ParseOption(int argc, char* argv[], const std::string& option) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == option) {
+            return argv[i + 1];
+        }
+    }
+    return "";
+}
+
+void Headless::RecordImageCommands(size_t count) {
+    imageCommands += count;
+}
+
+void Headless::RecordTextCommands(size_t count) {
+    textCommands += count;
+}
+
+void Headless::PrintSummary(int frames, double seconds) {
+    std::cout << "headless: simulated " << frames << " frames in " << seconds << "s";
+    if (seconds > 0.0) {
+        std::cout << " (" << (frames / seconds) << " fps)";
+    }
+    std::cout << std::endl;
+    std::cout << "headless: recorded " << imageCommands << " image commands, "
+              << textCommands << " text commands" << std::endl;
+}
@@ -0,0 +1,170 @@
+// image_bench: startup image loading, serial (IMG_LoadTexture one after another,
+// as ImageDB used to) against ImageDecoder's parallel decode with upload on the
+// main thread. Textures go to a software renderer, so no window is needed.
+// Usage: image_bench [--runs N] [--threads N] [--synthetic N] [game ...]
+//   games default to every folder under resources with an images directory;
+//   --synthetic N also benchmarks N generated 512x512 PNGs.
+#include "headers/ImageDecoder.h"
+#include "SDL.h"
+#include "SDL_image.h"
+#define _SILENCE_EXPERIMENTAL_FILESYSTEM_DEPRECATION_WARNING
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+        return elapsed.count();
+    }
+
+    std::vector<std::string> pngsIn(const std::filesystem::path& directory) {
+        std::vector<std::string> paths;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".png") {
+                paths.push_back(entry.path().string());
+            }
+        }
+        std::sort(paths.begin(), paths.end());
+        return paths;
+    }
+
+    double loadSerial(const std::vector<std::string>& paths, SDL_Renderer* renderer) {
+        std::vector<SDL_Texture*> textures;
+        auto start = Clock::now();
+        for (const std::string& path : paths) {
+            textures.push_back(IMG_LoadTexture(renderer, path.c_str()));
+        }
+        double elapsed = millisecondsSince(start);
+        for (SDL_Texture* texture : textures) {
+            SDL_DestroyTexture(texture);
+        }
+        return elapsed;
+    }
+
+    double loadParallel(const std::vector<std::string>& paths, SDL_Renderer* renderer) {
+        std::vector<SDL_Texture*> textures;
+        auto start = Clock::now();
+        ImageDecoder::DecodeAll(paths, [&](size_t, SDL_Surface* surface) {
+            if (surface) {
+                textures.push_back(SDL_CreateTextureFromSurface(renderer, surface));
+                SDL_FreeSurface(surface);
+            }
+            });
+        double elapsed = millisecondsSince(start);
+        for (SDL_Texture* texture : textures) {
+            SDL_DestroyTexture(texture);
+        }
+        return elapsed;
+    }
+
+    void benchmark(const std::string& label, const std::vector<std::string>& paths, SDL_Renderer* renderer, int runs) {
+        loadSerial(paths, renderer); // warm the file cache so neither side pays for the disk
+
+        double serial = 1e30;
+        double parallel = 1e30;
+        for (int run = 0; run < runs; ++run) {
+            serial = std::min(serial, loadSerial(paths, renderer));
+            parallel = std::min(parallel, loadParallel(paths, renderer));
+        }
+        std::cout << label << ": " << paths.size() << " images, serial " << serial << " ms, parallel "
+            << parallel << " ms on " << ImageDecoder::WorkerCount() << " threads ("
+            << (parallel > 0.0 ? serial / parallel : 0.0) << "x)" << std::endl;
+    }
+
+    std::filesystem::path writeSynthetic(int count) {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "image_bench";
+        std::filesystem::create_directories(directory);
+        std::mt19937 random(498);
+        for (int i = 0; i < count; ++i) {
+            SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, 512, 512, 32, SDL_PIXELFORMAT_RGBA32);
+            Uint32* pixels = static_cast<Uint32*>(surface->pixels);
+            // Gradient plus noise, so it compresses about as badly as real art
+            for (int y = 0; y < 512; ++y) {
+                for (int x = 0; x < 512; ++x) {
+                    Uint8 noise = static_cast<Uint8>(random() & 0x3F);
+                    pixels[y * (surface->pitch / 4) + x] = SDL_MapRGBA(surface->format, static_cast<Uint8>(x / 2) ^ noise, static_cast<Uint8>(y / 2), static_cast<Uint8>(i * 7), 255);
+                }
+            }
+            IMG_SavePNG(surface, (directory / ("synthetic" + std::to_string(i) + ".png")).string().c_str());
+            SDL_FreeSurface(surface);
+        }
+        return directory;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int runs = 3;
+    int synthetic = 0;
+    std::vector<std::string> games;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--runs" && i + 1 < argc) {
+            runs = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (argument == "--threads" && i + 1 < argc) {
+            ImageDecoder::Resize(static_cast<unsigned int>(std::max(0, std::atoi(argv[++i]))));
+        }
+        else if (argument == "--synthetic" && i + 1 < argc) {
+            synthetic = std::max(0, std::atoi(argv[++i]));
+        }
+        else {
+            games.push_back(argument);
+        }
+    }
+    if (games.empty() && std::filesystem::is_directory("resources")) {
+        for (const auto& entry : std::filesystem::directory_iterator("resources")) {
+            if (std::filesystem::is_directory(entry.path() / "images")) {
+                games.push_back(entry.path().filename().string());
+            }
+        }
+        std::sort(games.begin(), games.end());
+    }
+
+    if (SDL_Init(0) != 0 || !(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+        std::cout << "error: could not initialize SDL_image: " << IMG_GetError() << std::endl;
+        return 1;
+    }
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_RGBA32);
+    SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(target);
+    if (!renderer) {
+        std::cout << "error: could not create a renderer: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    for (const std::string& game : games) {
+        std::filesystem::path directory = std::filesystem::path{ "resources" } / game / "images";
+        if (!std::filesystem::is_directory(directory)) {
+            std::cout << "error: " << directory.string() << " is not a directory" << std::endl;
+            return 1;
+        }
+        std::vector<std::string> paths = pngsIn(directory);
+        if (paths.empty()) {
+            std::cout << game << ": no images" << std::endl;
+            continue;
+        }
+        benchmark(game, paths, renderer, runs);
+    }
+    if (synthetic > 0) {
+        std::filesystem::path directory = writeSynthetic(synthetic);
+        benchmark("synthetic", pngsIn(directory), renderer, runs);
+        std::filesystem::remove_all(directory);
+    }
+    if (games.empty() && synthetic == 0) {
+        std::cout << "image_bench: no game under resources has images; try --synthetic 256" << std::endl;
+    }
+
+    ImageDecoder::Shutdown();
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    IMG_Quit();
+    SDL_Quit();
+    return 0;
+}
@@ -1,4 +1,8 @@
 #include "headers/ImageDB.h"
+#include "headers/ImageRegistry.h"
+#include "headers/RenderQueue.h"
+#include "headers/AssetPreloader.h"
+#include "headers/TextureBudget.h"
 
 std::unordered_map<std::string, SDL_Texture*> ImageDB::imageCache;
 std::vector<RenderRequest> ImageDB::requests;
@@ -10,6 +14,7 @@ ImageDB::ImageDB() {
         std::cout << "SDL_image could not initialize! SDL_image Error: " << IMG_GetError();
         exit(0);
     }
+    TextureBudget::Attach(&imageCache);
 }
 
 ImageDB::~ImageDB() {
@@ -20,6 +25,7 @@ SDL_Texture* ImageDB::loadImage(const std::string& imageName, SDL_Renderer* rend
     // Check if the image is already loaded
     auto it = imageCache.find(imageName);
     if (it != imageCache.end()) {
+        TextureBudget::Touch(imageName);
         return it->second; // Return the cached texture
     }
 
@@ -27,8 +33,15 @@ SDL_Texture* ImageDB::loadImage(const std::string& imageName, SDL_Renderer* rend
     std::string imagePath = "resources/" + gamePlaying + "/images/" + imageName + ".png";
 
   
-    // Load the image into a texture
-    SDL_Texture* texture = IMG_LoadTexture(renderer, imagePath.c_str());
+    // Load the image into a texture, from the surface AssetPreloader decoded if there is one
+    SDL_Texture* texture = nullptr;
+    if (SDL_Surface* decoded = AssetPreloader::TakeImage(imageName)) {
+        texture = SDL_CreateTextureFromSurface(renderer, decoded);
+        SDL_FreeSurface(decoded);
+    }
+    else {
+        texture = IMG_LoadTexture(renderer, imagePath.c_str());
+    }
     if (!texture) {
         std::cout << "error: missing image " << imageName;
         exit(0);
@@ -36,6 +49,7 @@ SDL_Texture* ImageDB::loadImage(const std::string& imageName, SDL_Renderer* rend
 
     // Store the texture in the cache and return it
     imageCache[imageName] = texture; 
+    TextureBudget::Track(imageName, texture);
     return texture;
 }
 
@@ -45,75 +59,41 @@ void ImageDB::clear() {
         SDL_DestroyTexture(pair.second);
     }
     imageCache.clear(); // Clear the map
+    TextureBudget::Clear();
 }
 
+// Only the first check of a name touches the filesystem; see ImageRegistry
 void ImageDB::checkImageExists(const std::string& imageName) {
-    std::filesystem::path imagePath{ "resources/" + gamePlaying + "/images/" + imageName + ".png"};
-    if (!std::filesystem::exists(imagePath)) {
-        std::cout << "error: missing image " << imageName;
-        exit(0);
-    }
+    ImageRegistry::Resolve(imageName);
 }
 
 void ImageDB::DrawUI(std::string imageName, float x, float y) {
-    checkImageExists(imageName);
-    RenderRequest request(RenderRequest::ImageType::UI, imageName, x, y, 0);
-    requests.push_back(request);
+    RenderQueue::Push(RenderCommand::Make(RenderRequest::ImageType::UI, ImageRegistry::Resolve(imageName), x, y, 0));
 }
 
 void ImageDB::DrawUIEx(std::string imageName, float x, float y, float r, float g, float b, float a, int sorting_order) {
-   
-    checkImageExists(imageName);
-    RenderRequest request(RenderRequest::ImageType::UI, imageName, x, y, sorting_order);
-    // Set color and alpha values
-    request.r = static_cast<int>(std::floor(r));
-    request.g = static_cast<int>(std::floor(g));
-    request.b = static_cast<int>(std::floor(b));
-    request.a = static_cast<int>(std::floor(a));
-    // Queue the request
-    requests.push_back(request);
+    RenderQueue::PushUIEx(ImageRegistry::Resolve(imageName), x, y, r, g, b, a, sorting_order);
 }
 
 
 void ImageDB::Draw(std::string imageName, float x, float y) {
-    // Check if the image is loaded, load it if not
-    checkImageExists(imageName);
-    // Create a RenderRequest for the scene image
-    RenderRequest request(RenderRequest::ImageType::Scene, imageName, x, y);
-    // Queue the request
-    requests.push_back(request);
+    // Resolve (and on first use validate) the image, then queue the command
+    RenderQueue::Push(RenderCommand::Make(RenderRequest::ImageType::Scene, ImageRegistry::Resolve(imageName), x, y, 0));
 }
 
 void ImageDB::DrawEx(std::string imageName, float x, float y, float rotation_degrees, float scale_x, float scale_y, float pivot_x, float pivot_y, float r, float g, float b, float a, int sorting_order) {
-    // Ensure the image is in the cache
-    checkImageExists(imageName);
-
-    // Create an extended RenderRequest with all properties
-    RenderRequest request(RenderRequest::ImageType::Scene, imageName, x, y, sorting_order);
-    request.rotation_degrees = static_cast<int>(rotation_degrees);
-    request.scale_x = scale_x;
-    request.scale_y = scale_y;
-    request.pivot_x = pivot_x;
-    request.pivot_y = pivot_y;
-    request.r = static_cast<int>(r);
-    request.g = static_cast<int>(g);
-    request.b = static_cast<int>(b);
-    request.a = static_cast<int>(a);
-
-    // Queue the request
-    requests.push_back(request);
+    RenderQueue::PushSceneEx(ImageRegistry::Resolve(imageName), x, y, rotation_degrees, scale_x, scale_y, pivot_x, pivot_y, r, g, b, a, sorting_order);
 }
 
 void ImageDB::DrawPixel(float x, float y, float r, float g, float b, float a) {
-    RenderRequest request(RenderRequest::ImageType::Pixel, "", x, y);
-    request.r = static_cast<int>(r);
-    request.g = static_cast<int>(g);
-    request.b = static_cast<int>(b);
-    request.a = static_cast<int>(a);
+    RenderCommand command = RenderCommand::Make(RenderRequest::ImageType::Pixel, -1, x, y, 0);
+    command.color = RenderCommand::PackColor(static_cast<int>(r), static_cast<int>(g), static_cast<int>(b), static_cast<int>(a));
 
-    requests.push_back(request);
+    RenderQueue::Push(command);
 }
 
 void ImageDB::clearAll() {
-    imageCache.clear(); requests.clear();
+    clear(); requests.clear(); // destroys the textures too; they belong to the renderer being replaced
+    RenderQueue::Clear();
+    ImageRegistry::Clear();
 }
\ No newline at end of file
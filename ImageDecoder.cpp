@@ -0,0 +1,143 @@
+#include "headers/ImageDecoder.h"
+#include "SDL.h"
+#include "SDL_image.h"
+#include <algorithm>
+
+size_t ImageDecoder::queueCapacity = 16;
+unsigned int ImageDecoder::threadCount = 0;
+std::mutex ImageDecoder::mutex;
+std::condition_variable ImageDecoder::jobReady;
+std::deque<ImageDecoder::Job> ImageDecoder::jobs;
+std::vector<std::thread> ImageDecoder::workers;
+bool ImageDecoder::stopping = false;
+
+namespace {
+    // Joins the decode workers at exit, before the statics above are destroyed
+    struct DecoderShutdown {
+        ~DecoderShutdown() { ImageDecoder::Shutdown(); }
+    } decoderShutdown;
+}
+
+// One DecodeAll call; guarded by ImageDecoder::mutex
+struct ImageDecoder::Batch {
+    const std::vector<std::string>* paths;
+    bool convertToRGBA32;
+    const std::atomic<bool>* cancel;
+    size_t capacity;
+    size_t inFlight = 0; // decoding or waiting in results
+    std::deque<std::pair<size_t, SDL_Surface*>> results;
+    std::condition_variable resultReady;
+};
+
+void ImageDecoder::DecodeAll(const std::vector<std::string>& paths, const Consumer& consume, bool convertToRGBA32, const std::atomic<bool>* cancel) {
+    if (paths.empty()) {
+        return;
+    }
+    start();
+
+    Batch batch;
+    batch.paths = &paths;
+    batch.convertToRGBA32 = convertToRGBA32;
+    batch.cancel = cancel;
+    batch.capacity = std::max<size_t>(1, queueCapacity);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < paths.size(); ++i) {
+            jobs.push_back({ &batch, i });
+        }
+    }
+    jobReady.notify_all();
+
+    for (size_t received = 0; received < paths.size(); ++received) {
+        std::pair<size_t, SDL_Surface*> result;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            batch.resultReady.wait(lock, [&batch]() { return !batch.results.empty(); });
+            result = batch.results.front();
+            batch.results.pop_front();
+            batch.inFlight--;
+        }
+        jobReady.notify_one(); // room for another job of this batch
+        consume(result.first, result.second);
+    }
+}
+
+void ImageDecoder::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        // Skip over batches whose queue is full; their consumer is still busy
+        auto job = jobs.end();
+        jobReady.wait(lock, [&job]() {
+            if (stopping) {
+                return true;
+            }
+            job = std::find_if(jobs.begin(), jobs.end(), [](const Job& queued) { return queued.batch->inFlight < queued.batch->capacity; });
+            return job != jobs.end();
+            });
+        if (stopping) {
+            return;
+        }
+        Job current = *job;
+        jobs.erase(job);
+        Batch& batch = *current.batch;
+        batch.inFlight++;
+        lock.unlock();
+
+        SDL_Surface* surface = nullptr;
+        if (!batch.cancel || !batch.cancel->load()) {
+            surface = decode((*batch.paths)[current.index], batch.convertToRGBA32);
+        }
+
+        lock.lock();
+        batch.results.emplace_back(current.index, surface);
+        batch.resultReady.notify_one();
+    }
+}
+
+SDL_Surface* ImageDecoder::decode(const std::string& path, bool convertToRGBA32) {
+    SDL_Surface* surface = IMG_Load(path.c_str());
+    if (!surface || !convertToRGBA32) {
+        return surface;
+    }
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(surface);
+    return converted;
+}
+
+void ImageDecoder::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!workers.empty()) {
+        return;
+    }
+    stopping = false;
+    unsigned int count = threadCount > 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0; i < count; ++i) {
+        workers.emplace_back(&ImageDecoder::workerLoop);
+    }
+}
+
+void ImageDecoder::Resize(unsigned int threads) {
+    if (threads == threadCount) {
+        return;
+    }
+    Shutdown();
+    threadCount = threads;
+}
+
+void ImageDecoder::Shutdown() {
+    std::vector<std::thread> stopped;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        stopped.swap(workers);
+    }
+    jobReady.notify_all();
+    for (std::thread& worker : stopped) {
+        worker.join();
+    }
+}
+
+unsigned int ImageDecoder::WorkerCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<unsigned int>(workers.size());
+}
@@ -0,0 +1,67 @@
+#include "headers/ImageRegistry.h"
+#include "headers/RenderQueue.h"
+#include <filesystem>
+#include <iostream>
+
+extern std::string gamePlaying;
+
+std::unordered_map<std::string, int> ImageRegistry::idsByName;
+std::vector<std::string> ImageRegistry::names;
+
+int ImageRegistry::Resolve(const std::string& imageName) {
+    auto it = idsByName.find(imageName);
+    if (it != idsByName.end()) {
+        return it->second;
+    }
+
+    std::filesystem::path imagePath{ "resources/" + gamePlaying + "/images/" + imageName + ".png" };
+    if (!std::filesystem::exists(imagePath)) {
+        std::cout << "error: missing image " << imageName;
+        exit(0);
+    }
+
+    int imageId = static_cast<int>(names.size());
+    names.push_back(imageName);
+    idsByName[imageName] = imageId;
+    return imageId;
+}
+
+const std::string* ImageRegistry::NameOf(int imageId) {
+    if (imageId < 0 || imageId >= static_cast<int>(names.size())) {
+        return nullptr;
+    }
+    return &names[imageId];
+}
+
+void ImageRegistry::Clear() {
+    idsByName.clear();
+    names.clear();
+}
+
+int ImageRegistry::Load(std::string imageName) {
+    return Resolve(imageName);
+}
+
+static int checkImageId(int imageId) {
+    if (!ImageRegistry::NameOf(imageId)) {
+        std::cout << "error: invalid image id " << imageId;
+        exit(0);
+    }
+    return imageId;
+}
+
+void ImageRegistry::DrawUIById(int imageId, float x, float y) {
+    RenderQueue::Push(RenderCommand::Make(RenderRequest::ImageType::UI, checkImageId(imageId), x, y, 0));
+}
+
+void ImageRegistry::DrawUIExById(int imageId, float x, float y, float r, float g, float b, float a, int sorting_order) {
+    RenderQueue::PushUIEx(checkImageId(imageId), x, y, r, g, b, a, sorting_order);
+}
+
+void ImageRegistry::DrawById(int imageId, float x, float y) {
+    RenderQueue::Push(RenderCommand::Make(RenderRequest::ImageType::Scene, checkImageId(imageId), x, y, 0));
+}
+
+void ImageRegistry::DrawExById(int imageId, float x, float y, float rotation_degrees, float scale_x, float scale_y, float pivot_x, float pivot_y, float r, float g, float b, float a, int sorting_order) {
+    RenderQueue::PushSceneEx(checkImageId(imageId), x, y, rotation_degrees, scale_x, scale_y, pivot_x, pivot_y, r, g, b, a, sorting_order);
+}
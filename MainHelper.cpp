@@ -5,6 +5,15 @@
 #include "headers/RayCasting.h"
 #include "headers/Eventbus.h"
 #include "headers/GameManager.h"
+#include "headers/ActorRegistry.h"
+#include "headers/ImageRegistry.h"
+#include "headers/SpatialIndex.h"
+#include "headers/PhysicsCasts.h"
+#include "headers/CollisionFilters.h"
+#include "headers/ActivityManager.h"
+#include "headers/ActorPool.h"
+#include "headers/SceneLoader.h"
+#include "headers/AssetPreloader.h"
 
 
 lua_State* LuaHelper::L;
@@ -66,13 +75,36 @@ static void Application_OpenURL(const std::string& url) {
     std::system(command.c_str());
 }
 
+// Opt-in memoization for Actor.FindAll, enabled with Actor.SetFindAllCaching(true).
+// A cached table is reused until the set of actors with that name changes, so
+// scripts that turn it on must treat FindAll results as read-only.
+static bool cacheFindAllResults = false;
+static std::unordered_map<std::string, std::pair<uint64_t, luabridge::LuaRef>> findAllCache;
+
+static void SetFindAllCaching(bool enabled) {
+    cacheFindAllResults = enabled;
+    findAllCache.clear();
+}
+
 // Wrapper function to handle conversion to Lua table
 luabridge::LuaRef FindAllActorsByNameLua(const std::string& name, lua_State* L) {
+    uint64_t version = ActorRegistry::NameVersion(name);
+    if (cacheFindAllResults) {
+        auto cached = findAllCache.find(name);
+        if (cached != findAllCache.end() && cached->second.first == version) {
+            return cached->second.second;
+        }
+    }
+
     auto foundActors = Actor::FindAll(name);
     luabridge::LuaRef table = luabridge::newTable(L);
     for (size_t i = 0; i < foundActors.size(); ++i) {
         table[i + 1] = foundActors[i];
     }
+
+    if (cacheFindAllResults) {
+        findAllCache.insert_or_assign(name, std::make_pair(version, table));
+    }
     return table;
 }
 
@@ -86,10 +118,13 @@ void exposeActortoLua(lua_State* L) {
         .addFunction("GetComponents", &Actor::GetComponents)
         .addStaticFunction("Find", &Actor::Find)
         .addStaticFunction("FindAll", &FindAllActorsByNameLua)
+        .addStaticFunction("SetFindAllCaching", &SetFindAllCaching)
         .addFunction("AddComponent", &Actor::addComponentFromLua)
         .addFunction("RemoveComponent", &Actor::removeComponentFromLua)
+        .addFunction("IsDormant", &ActivityManager::IsDormant)
         .addStaticFunction("Instantiate", &Actor::InstantiateNewActor)
         .addStaticFunction("Destroy", &Actor::DestoryActorFromLua)
+        .addStaticFunction("GetPoolStats", &ActorPool::GetStats)
         .endClass();
 }
 
@@ -100,6 +135,7 @@ void exposeApplicationtoLua(lua_State* L) {
         .addFunction("Sleep", &Application_Sleep)
         .addFunction("GetFrame", &Application_GetFrame)
         .addFunction("OpenURL", &Application_OpenURL)
+        .addFunction("GetPreloadStats", &AssetPreloader::GetStats)
         .endNamespace();
 }
 
@@ -149,6 +185,11 @@ void exportImageToLua(lua_State* L) {
         .addStaticFunction("Draw", &ImageDB::Draw)
         .addStaticFunction("DrawEx", &ImageDB::DrawEx)
         .addStaticFunction("DrawPixel", &ImageDB::DrawPixel)
+        .addStaticFunction("Load", &ImageRegistry::Load)
+        .addStaticFunction("DrawById", &ImageRegistry::DrawById)
+        .addStaticFunction("DrawExById", &ImageRegistry::DrawExById)
+        .addStaticFunction("DrawUIById", &ImageRegistry::DrawUIById)
+        .addStaticFunction("DrawUIExById", &ImageRegistry::DrawUIExById)
         .endClass();
 }
 
@@ -167,6 +208,9 @@ void exportSceneToLua(lua_State* L) {
     luabridge::getGlobalNamespace(L)
         .beginClass<Scene>("Scene")
         .addStaticFunction("Load", &Scene::loadNewScene)
+        .addStaticFunction("LoadAsync", &SceneLoader::LoadAsync)
+        .addStaticFunction("GetLoadProgress", &SceneLoader::GetProgress)
+        .addStaticFunction("IsLoading", &SceneLoader::IsLoading)
         .addStaticFunction("GetCurrent", &Scene::GetCurrent)
         .addStaticFunction("DontDestroy", &Scene::DontDestroyOnLoad)
        .endClass();
@@ -203,6 +247,18 @@ void exportRigidBodyToLua(lua_State* L) {
         .addData("trigger_height", &RigidBody::trigger_height)
         .addData("trigger_radius", &RigidBody::trigger_radius)
 
+        // Collision filtering
+        .addProperty("layer", &CollisionFilters::GetLayer, &CollisionFilters::SetLayer)
+        .addProperty("collides_with", &CollisionFilters::GetCollidesWith, &CollisionFilters::SetCollidesWith)
+        .addProperty("collision_group", &CollisionFilters::GetGroup, &CollisionFilters::SetGroup)
+
+        // Sleep and dormancy
+        .addProperty("can_go_dormant", &ActivityManager::GetCanGoDormant, &ActivityManager::SetCanGoDormant)
+        .addFunction("IsAwake", &ActivityManager::IsAwake)
+        .addFunction("SetAwake", &ActivityManager::SetAwake)
+        .addFunction("IsSleepingAllowed", &ActivityManager::IsSleepingAllowed)
+        .addFunction("SetSleepingAllowed", &ActivityManager::SetSleepingAllowed)
+
         // Expose methods
         .addFunction("GetPosition", &RigidBody::GetPosition)
         .addFunction("GetRotation", &RigidBody::GetRotation)
@@ -256,6 +312,14 @@ void exportPhysicsToLua(lua_State* L) {
         .beginClass<Physics>("Physics")
         .addStaticFunction("Raycast", &Physics::Raycast)
         .addStaticFunction("RaycastAll", &Physics::RaycastAll)
+        .addStaticFunction("RaycastBatch", &PhysicsCasts::RaycastBatch)
+        .addStaticFunction("CircleCast", &PhysicsCasts::CircleCast)
+        .addStaticFunction("BoxCast", &PhysicsCasts::BoxCast)
+        .addStaticFunction("OverlapCircle", &SpatialIndex::OverlapCircle)
+        .addStaticFunction("OverlapBox", &SpatialIndex::OverlapBox)
+        .addStaticFunction("Nearest", &SpatialIndex::Nearest)
+        .addStaticFunction("Track", &SpatialIndex::Track)
+        .addStaticFunction("Untrack", &SpatialIndex::Untrack)
         .endClass();
 
 }
@@ -0,0 +1,284 @@
+#include "headers/PhysicsCasts.h"
+#include "headers/RigidBody.h"
+#include "headers/MainHelper.h"
+#include "headers/SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+size_t PhysicsCasts::parallelThreshold = 256;
+std::vector<PhysicsCasts::Ray> PhysicsCasts::rays;
+std::vector<HitResult> PhysicsCasts::hits;
+std::vector<char> PhysicsCasts::didHit;
+std::vector<std::thread> PhysicsCasts::workers;
+std::mutex PhysicsCasts::mutex;
+std::condition_variable PhysicsCasts::workReady;
+std::condition_variable PhysicsCasts::workDone;
+size_t PhysicsCasts::chunkSize = 0;
+size_t PhysicsCasts::chunkCount = 0;
+size_t PhysicsCasts::nextChunk = 0;
+size_t PhysicsCasts::chunksDone = 0;
+bool PhysicsCasts::stopping = false;
+
+namespace {
+    // The cast workers are std::threads, which terminate the program if still joinable when destroyed
+    struct CastPoolShutdown {
+        ~CastPoolShutdown() { PhysicsCasts::Shutdown(); }
+    } castPoolShutdown;
+}
+
+void PhysicsCasts::castRange(const std::vector<Ray>& rays, std::vector<HitResult>& hits, std::vector<char>& didHit, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        // Same callback as Physics.Raycast, so a batch reports exactly what single casts would
+        FirstHitRayCastCallback callback;
+        RigidBody::world->RayCast(&callback, rays[i].start, rays[i].end);
+        didHit[i] = callback.hit ? 1 : 0;
+        if (callback.hit) {
+            hits[i] = callback.hitResult;
+        }
+    }
+}
+
+// Only a HitResult from an earlier batch may be overwritten in place; any other
+// userdata a script left in the table (a Vector2, an Actor) is replaced instead
+static bool isHitResult(const luabridge::LuaRef& ref) {
+    lua_State* L = LuaHelper::L;
+    ref.push(L);
+    bool isInstance = luabridge::Stack<HitResult*>::isInstance(L, -1);
+    lua_pop(L, 1);
+    return isInstance;
+}
+
+luabridge::LuaRef PhysicsCasts::RaycastBatch(luabridge::LuaRef origins, luabridge::LuaRef dirs, luabridge::LuaRef dists, luabridge::LuaRef results) {
+    if (!results.isTable()) {
+        results = luabridge::newTable(LuaHelper::L);
+    }
+    if (!origins.isTable() || !dirs.isTable()) {
+        return results;
+    }
+
+    // Gather every ray on this thread; the Lua state is not touched again until the writes
+    size_t count = std::min(static_cast<size_t>(origins.length()), static_cast<size_t>(dirs.length()));
+    bool sameDistance = dists.isNumber();
+    float distance = sameDistance ? dists.cast<float>() : 0.0f;
+
+    rays.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        Vector2 origin = origins[i + 1].cast<Vector2>();
+        Vector2 dir = dirs[i + 1].cast<Vector2>();
+        if (!sameDistance) {
+            luabridge::LuaRef entry = dists[i + 1];
+            distance = entry.isNumber() ? entry.cast<float>() : 0.0f;
+        }
+        rays[i].start = b2Vec2(origin.getX(), origin.getY());
+        rays[i].end = b2Vec2(origin.getX() + dir.getX() * distance, origin.getY() + dir.getY() * distance);
+    }
+
+    hits.assign(count, HitResult(nullptr, b2Vec2_zero, b2Vec2_zero, 0.0f, false));
+    didHit.assign(count, 0);
+
+    if (RigidBody::world && count > 0) {
+        size_t threads = std::thread::hardware_concurrency();
+        // A locked world is mid-Step (a collision callback is casting); stay on this thread
+        if (parallelThreshold == 0 || count < parallelThreshold || threads < 2 || RigidBody::world->IsLocked()) {
+            castRange(rays, hits, didHit, 0, count);
+        }
+        else {
+            // Keep every thread busy with at least half a threshold of rays
+            castParallel(count, std::min(threads, count / std::max<size_t>(1, parallelThreshold / 2)));
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        luabridge::LuaRef slot = results[i + 1];
+        if (!didHit[i]) {
+            results[i + 1] = false;
+        }
+        else if (slot.isUserdata() && isHitResult(slot)) {
+            *slot.cast<HitResult*>() = hits[i];
+        }
+        else {
+            results[i + 1] = hits[i];
+        }
+    }
+
+    // Drop entries left over from a longer batch
+    for (size_t i = count + 1; !results[i].isNil(); ++i) {
+        results[i] = luabridge::LuaRef(LuaHelper::L);
+    }
+    return results;
+}
+
+void PhysicsCasts::castParallel(size_t count, size_t chunks) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (workers.empty()) {
+        // The calling thread takes chunks too
+        stopping = false;
+        unsigned int threads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+        for (unsigned int i = 0; i < threads; ++i) {
+            workers.emplace_back(&PhysicsCasts::workerLoop);
+        }
+    }
+
+    chunkSize = (count + chunks - 1) / chunks;
+    chunkCount = (count + chunkSize - 1) / chunkSize;
+    nextChunk = 0;
+    chunksDone = 0;
+    workReady.notify_all();
+
+    while (nextChunk < chunkCount) {
+        size_t chunk = nextChunk++;
+        lock.unlock();
+        castChunk(chunk);
+        lock.lock();
+        chunksDone++;
+    }
+    workDone.wait(lock, []() { return chunksDone == chunkCount; });
+    chunkCount = 0;
+    nextChunk = 0;
+}
+
+void PhysicsCasts::castChunk(size_t chunk) {
+    size_t begin = chunk * chunkSize;
+    castRange(rays, hits, didHit, begin, std::min(begin + chunkSize, rays.size()));
+}
+
+void PhysicsCasts::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        workReady.wait(lock, []() { return stopping || nextChunk < chunkCount; });
+        if (stopping) {
+            return;
+        }
+        size_t chunk = nextChunk++;
+        lock.unlock();
+        castChunk(chunk);
+        lock.lock();
+        if (++chunksDone == chunkCount) {
+            workDone.notify_all();
+        }
+    }
+}
+
+void PhysicsCasts::Shutdown() {
+    std::vector<std::thread> stopped;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        stopped.swap(workers);
+    }
+    workReady.notify_all();
+    for (std::thread& worker : stopped) {
+        worker.join();
+    }
+}
+
+luabridge::LuaRef PhysicsCasts::shapeCast(const b2Shape& shape, Vector2 origin, Vector2 dir, float dist) {
+    if (!RigidBody::world) {
+        return luabridge::LuaRef(LuaHelper::L);
+    }
+
+    b2Vec2 start(origin.getX(), origin.getY());
+    b2Vec2 translation(dir.getX() * dist, dir.getY() * dist);
+    b2Vec2 end = start + translation;
+
+    // Bounds of the shape over the whole sweep
+    b2AABB startBounds, endBounds, sweptBounds;
+    shape.ComputeAABB(&startBounds, b2Transform(start, b2Rot(0.0f)), 0);
+    shape.ComputeAABB(&endBounds, b2Transform(end, b2Rot(0.0f)), 0);
+    sweptBounds.Combine(startBounds, endBounds);
+
+    b2Sweep castSweep;
+    castSweep.localCenter.SetZero();
+    castSweep.c0 = start;
+    castSweep.c = end;
+    castSweep.a0 = castSweep.a = 0.0f;
+    castSweep.alpha0 = 0.0f;
+
+    b2DistanceProxy castProxy;
+    castProxy.Set(&shape, 0);
+
+    bool hit = false;
+    HitResult closest(nullptr, b2Vec2_zero, b2Vec2_zero, 1.0f, false);
+
+    for (b2Fixture* fixture : SpatialIndex::QueryFixtures(sweptBounds)) {
+        Actor* actor = reinterpret_cast<Actor*>(fixture->GetUserData().pointer);
+        if (actor == nullptr || fixture->IsSensor()) {
+            continue;
+        }
+
+        const b2Body* body = fixture->GetBody();
+        b2Sweep bodySweep;
+        bodySweep.localCenter = body->GetLocalCenter();
+        bodySweep.c0 = bodySweep.c = body->GetWorldCenter();
+        bodySweep.a0 = bodySweep.a = body->GetAngle();
+        bodySweep.alpha0 = 0.0f;
+
+        const b2Shape* fixtureShape = fixture->GetShape();
+        for (int child = 0; child < fixtureShape->GetChildCount(); ++child) {
+            b2TOIInput input;
+            input.proxyA.Set(&shape, 0);
+            input.proxyB.Set(fixtureShape, child);
+            input.sweepA = castSweep;
+            input.sweepB = bodySweep;
+            input.tMax = 1.0f;
+
+            b2TOIOutput output;
+            b2TimeOfImpact(&output, &input);
+
+            float fraction;
+            if (output.state == b2TOIOutput::e_touching) {
+                fraction = output.t;
+            }
+            else if (output.state == b2TOIOutput::e_overlapped) {
+                fraction = 0.0f;
+            }
+            else {
+                continue;
+            }
+            if (hit && fraction >= closest.fraction) {
+                continue;
+            }
+
+            // Contact point and normal from the closest features at the time of impact
+            b2DistanceInput distanceInput;
+            distanceInput.proxyA = castProxy;
+            distanceInput.proxyB.Set(fixtureShape, child);
+            distanceInput.transformA = b2Transform(start + fraction * translation, b2Rot(0.0f));
+            distanceInput.transformB = body->GetTransform();
+            distanceInput.useRadii = true;
+
+            b2SimplexCache cache;
+            cache.count = 0;
+            b2DistanceOutput distanceOutput;
+            b2Distance(&distanceOutput, &cache, &distanceInput);
+
+            b2Vec2 normal = distanceOutput.pointA - distanceOutput.pointB;
+            if (normal.Normalize() < b2_epsilon) {
+                // Already overlapping: push back against the direction of travel
+                normal = -translation;
+                normal.Normalize();
+            }
+
+            closest = HitResult(actor, distanceOutput.pointB, normal, fraction, false);
+            hit = true;
+        }
+    }
+
+    if (!hit) {
+        return luabridge::LuaRef(LuaHelper::L);
+    }
+    return luabridge::LuaRef(LuaHelper::L, closest);
+}
+
+luabridge::LuaRef PhysicsCasts::CircleCast(Vector2 origin, float radius, Vector2 dir, float dist) {
+    b2CircleShape circle;
+    circle.m_radius = radius;
+    return shapeCast(circle, origin, dir, dist);
+}
+
+luabridge::LuaRef PhysicsCasts::BoxCast(Vector2 origin, Vector2 size, Vector2 dir, float dist) {
+    b2PolygonShape box;
+    box.SetAsBox(std::fabs(size.getX()) * 0.5f, std::fabs(size.getY()) * 0.5f);
+    return shapeCast(box, origin, dir, dist);
+}
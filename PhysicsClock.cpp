@@ -0,0 +1,104 @@
+#include "headers/PhysicsClock.h"
+#include "headers/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+float PhysicsClock::fixedStep = 1.0f / 60.0f;
+int PhysicsClock::velocityIterations = 8;
+int PhysicsClock::positionIterations = 3;
+int PhysicsClock::maxSubsteps = 5;
+bool PhysicsClock::interpolate = true;
+
+double PhysicsClock::accumulator = 0.0;
+int64_t PhysicsClock::lastMicros = 0;
+float PhysicsClock::alpha = 1.0f;
+int PhysicsClock::stepsLastFrame = 0;
+std::unordered_map<const b2Body*, PhysicsClock::Pose> PhysicsClock::previousPoses;
+
+void PhysicsClock::Advance(b2World* world) {
+    int64_t now = Profiler::NowMicros();
+#ifdef ENGINE_HEADLESS
+    double frameSeconds = fixedStep;
+#else
+    // The first frame after a reset gets exactly one step
+    double frameSeconds = lastMicros == 0 ? fixedStep : (now - lastMicros) / 1000000.0;
+#endif
+    lastMicros = now;
+
+    accumulator += frameSeconds;
+    stepsLastFrame = 0;
+    while (accumulator >= fixedStep && stepsLastFrame < maxSubsteps) {
+        // Only the pose before the frame's last step is blended from
+        bool lastStep = accumulator - fixedStep < fixedStep || stepsLastFrame + 1 == maxSubsteps;
+        if (interpolate && lastStep) {
+            snapshot(world);
+        }
+        world->Step(fixedStep, velocityIterations, positionIterations);
+        accumulator -= fixedStep;
+        stepsLastFrame++;
+    }
+
+    // Fell behind: drop what is left instead of carrying the debt into the next frame
+    if (accumulator >= fixedStep) {
+        accumulator = std::fmod(accumulator, static_cast<double>(fixedStep));
+    }
+    alpha = static_cast<float>(accumulator / fixedStep);
+}
+
+void PhysicsClock::Reset() {
+    accumulator = 0.0;
+    lastMicros = 0;
+    alpha = 1.0f;
+    stepsLastFrame = 0;
+    previousPoses.clear();
+}
+
+void PhysicsClock::snapshot(b2World* world) {
+    previousPoses.clear();
+    for (const b2Body* body = world->GetBodyList(); body; body = body->GetNext()) {
+        if (body->GetType() != b2_staticBody) {
+            previousPoses[body] = { body->GetPosition(), body->GetAngle() };
+        }
+    }
+}
+
+b2Vec2 PhysicsClock::InterpolatedPosition(const b2Body* body) {
+    b2Vec2 current = body->GetPosition();
+    if (!interpolate) {
+        return current;
+    }
+
+    auto it = previousPoses.find(body);
+    if (it == previousPoses.end()) {
+        return current;
+    }
+    const b2Vec2& previous = it->second.position;
+    return previous + alpha * (current - previous);
+}
+
+float PhysicsClock::InterpolatedAngle(const b2Body* body) {
+    float current = body->GetAngle();
+    if (!interpolate) {
+        return current;
+    }
+
+    auto it = previousPoses.find(body);
+    if (it == previousPoses.end()) {
+        return current;
+    }
+    // Box2D does not wrap angles, so a plain lerp never takes the long way round
+    float previous = it->second.angle;
+    return previous + alpha * (current - previous);
+}
+
+void PhysicsClock::Forget(const b2Body* body) {
+    previousPoses.erase(body);
+}
+
+void PhysicsClock::DestroyBody(b2Body*& body) {
+    if (body && RigidBody::world) {
+        previousPoses.erase(body);
+        RigidBody::world->DestroyBody(body);
+    }
+    body = nullptr;
+}
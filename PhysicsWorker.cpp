@@ -0,0 +1,38 @@
+#include "headers/PhysicsWorker.h"
+#include "headers/PhysicsClock.h"
+#include "headers/CollisionEvents.h"
+#include "headers/Profiler.h"
+
+bool PhysicsWorker::enabled = false;
+std::future<void> PhysicsWorker::pending;
+
+void PhysicsWorker::BeginStep() {
+    Wait();
+    if (!enabled || !RigidBody::world) {
+        return;
+    }
+
+    b2World* world = RigidBody::world;
+    pending = std::async(std::launch::async, [world]() {
+        PhysicsClock::Advance(world);
+    });
+}
+
+void PhysicsWorker::FinishStep() {
+    if (!pending.valid()) {
+        RigidBody::Step();
+        return;
+    }
+
+    {
+        ProfileScope scope("PhysicsWorker wait");
+        pending.get();
+    }
+    CollisionEvents::Dispatch();
+}
+
+void PhysicsWorker::Wait() {
+    if (pending.valid()) {
+        pending.get();
+    }
+}
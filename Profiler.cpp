@@ -0,0 +1,248 @@
+#include "headers/Profiler.h"
+#include "headers/RenderQueue.h"
+#include "headers/SpriteBatch.h"
+#include "headers/ActivityManager.h"
+#include "headers/ActorPool.h"
+#include "headers/AssetPreloader.h"
+#include "headers/TextureBudget.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+#ifndef ENGINE_HEADLESS
+#include "imgui.h"
+#endif
+
+bool Profiler::enabled = false;
+bool Profiler::captureTrace = false;
+
+std::unordered_map<std::string, ProfilerStat> Profiler::sections;
+std::unordered_map<std::string, ProfilerStat> Profiler::componentTypes;
+std::unordered_map<std::string, ProfilerStat> Profiler::actors;
+
+int64_t Profiler::frameStartMicros = 0;
+int Profiler::historyIndex = 0;
+std::vector<float> Profiler::frameHistoryMs(ProfilerStat::kHistoryFrames, 0.0f);
+std::vector<TraceEvent> Profiler::traceEvents;
+
+float ProfilerStat::AverageMs() const {
+    float total = 0.0f;
+    for (float ms : historyMs) {
+        total += ms;
+    }
+    return total / historyMs.size();
+}
+
+float ProfilerStat::PeakMs() const {
+    return *std::max_element(historyMs.begin(), historyMs.end());
+}
+
+int64_t Profiler::NowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::BeginFrame() {
+    if (!enabled) return;
+    frameStartMicros = NowMicros();
+}
+
+static void rollHistory(std::unordered_map<std::string, ProfilerStat>& stats, int index) {
+    for (auto& [name, stat] : stats) {
+        stat.historyMs[index] = stat.frameMicros / 1000.0f;
+        stat.frameMicros = 0;
+    }
+}
+
+static void discardFrame(std::unordered_map<std::string, ProfilerStat>& stats) {
+    for (auto& [name, stat] : stats) {
+        stat.frameMicros = 0;
+    }
+}
+
+void Profiler::EndFrame() {
+    if (!enabled) return;
+
+    // Turned on mid-frame (the ImGui checkbox): BeginFrame did not run, so there is no frame to record
+    if (frameStartMicros == 0) {
+        discardFrame(sections);
+        discardFrame(componentTypes);
+        discardFrame(actors);
+        return;
+    }
+
+    int64_t frameMicros = NowMicros() - frameStartMicros;
+    frameHistoryMs[historyIndex] = frameMicros / 1000.0f;
+    if (captureTrace && traceEvents.size() < kMaxTraceEvents) {
+        traceEvents.push_back({ "Frame", "", "frame", frameStartMicros, frameMicros });
+    }
+
+    rollHistory(sections, historyIndex);
+    rollHistory(componentTypes, historyIndex);
+    rollHistory(actors, historyIndex);
+
+    historyIndex = (historyIndex + 1) % ProfilerStat::kHistoryFrames;
+    frameStartMicros = 0;
+}
+
+void Profiler::AddSample(ProfileCategory category, const std::string& name, int64_t startMicros, int64_t durationMicros) {
+    std::unordered_map<std::string, ProfilerStat>* stats = &sections;
+    const char* traceCategory = "section";
+    if (category == ProfileCategory::ComponentType) {
+        stats = &componentTypes;
+        traceCategory = "component";
+    }
+    else if (category == ProfileCategory::Actor) {
+        stats = &actors;
+        traceCategory = "actor";
+    }
+
+    ProfilerStat& stat = (*stats)[name];
+    stat.frameMicros += durationMicros;
+    stat.calls++;
+
+    // Component samples are already traced per call by RecordComponentCall.
+    if (captureTrace && category == ProfileCategory::Section && traceEvents.size() < kMaxTraceEvents) {
+        traceEvents.push_back({ name, "", traceCategory, startMicros, durationMicros });
+    }
+}
+
+void Profiler::RecordComponentCall(const char* phase, const std::string& componentType, const std::string& actorName, int64_t startMicros) {
+    int64_t duration = NowMicros() - startMicros;
+    AddSample(ProfileCategory::ComponentType, componentType, startMicros, duration);
+    AddSample(ProfileCategory::Actor, actorName, startMicros, duration);
+
+    if (captureTrace && traceEvents.size() < kMaxTraceEvents) {
+        traceEvents.push_back({ componentType + "." + phase, actorName, "component", startMicros, duration });
+    }
+}
+
+static void writeJsonString(std::ofstream& out, const std::string& value) {
+    out << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        }
+        else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+bool Profiler::DumpChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Profiler: could not open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    out << "{\"traceEvents\":[\n";
+    for (size_t i = 0; i < traceEvents.size(); ++i) {
+        const TraceEvent& event = traceEvents[i];
+        out << "{\"name\":";
+        writeJsonString(out, event.name);
+        out << ",\"cat\":\"" << event.category << "\",\"ph\":\"X\",\"ts\":" << event.startMicros
+            << ",\"dur\":" << event.durationMicros << ",\"pid\":1,\"tid\":1";
+        if (!event.detail.empty()) {
+            out << ",\"args\":{\"actor\":";
+            writeJsonString(out, event.detail);
+            out << "}";
+        }
+        out << "}" << (i + 1 < traceEvents.size() ? ",\n" : "\n");
+    }
+    out << "],\"displayTimeUnit\":\"ms\"}\n";
+
+    std::cout << "Profiler: wrote " << traceEvents.size() << " trace events to " << path << std::endl;
+    return true;
+}
+
+void Profiler::Reset() {
+    sections.clear();
+    componentTypes.clear();
+    actors.clear();
+    traceEvents.clear();
+    std::fill(frameHistoryMs.begin(), frameHistoryMs.end(), 0.0f);
+    historyIndex = 0;
+}
+
+#ifndef ENGINE_HEADLESS
+static void renderTopStats(const char* title, const std::unordered_map<std::string, ProfilerStat>& stats, size_t maxRows) {
+    std::vector<std::pair<float, const std::string*>> sorted;
+    sorted.reserve(stats.size());
+    for (const auto& [name, stat] : stats) {
+        sorted.push_back({ stat.AverageMs(), &name });
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first;
+        });
+
+    if (ImGui::CollapsingHeader(title, ImGuiTreeNodeFlags_DefaultOpen)) {
+        for (size_t i = 0; i < sorted.size() && i < maxRows; ++i) {
+            const ProfilerStat& stat = stats.at(*sorted[i].second);
+            ImGui::Text("%-28s avg %6.3f ms  peak %6.3f ms", sorted[i].second->c_str(), sorted[i].first, stat.PeakMs());
+        }
+    }
+}
+#endif
+
+void Profiler::RenderImGui() {
+#ifndef ENGINE_HEADLESS
+    ImGui::Begin("Profiler");
+
+    if (ImGui::Checkbox("Enable profiler", &enabled) && !enabled) {
+        captureTrace = false;
+    }
+    ImGui::SameLine();
+    ImGui::Checkbox("Record trace", &captureTrace);
+    if (captureTrace) {
+        enabled = true;
+    }
+
+    if (ImGui::Button("Dump Chrome Trace")) {
+        DumpChromeTrace("profile_trace.json");
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Reset")) {
+        Reset();
+    }
+
+    if (enabled) {
+        int lastFrame = (historyIndex + ProfilerStat::kHistoryFrames - 1) % ProfilerStat::kHistoryFrames;
+        ImGui::Text("Frame: %.3f ms", frameHistoryMs[lastFrame]);
+        ImGui::PlotLines("##frame", frameHistoryMs.data(), static_cast<int>(frameHistoryMs.size()), historyIndex, nullptr, 0.0f, 33.3f, ImVec2(0, 60));
+        ImGui::Text("Sprites: %llu drawn, %llu culled, %llu batches",
+            static_cast<unsigned long long>(RenderQueue::frameDrawn), static_cast<unsigned long long>(RenderQueue::frameCulled),
+            static_cast<unsigned long long>(SpriteBatch::frameBatches));
+        ImGui::Text("Dormant actors: %zu, pooled actors: %zu", ActivityManager::DormantIds().size(), ActorPool::AvailableCount());
+        ImGui::Text("Textures: %zu, %.1f of %.1f MB (%llu evicted, %llu reloaded)",
+            TextureBudget::TextureCount(), TextureBudget::BytesUsed() / (1024.0 * 1024.0), TextureBudget::budgetBytes / (1024.0 * 1024.0),
+            static_cast<unsigned long long>(TextureBudget::evictions), static_cast<unsigned long long>(TextureBudget::reloads));
+        ImGui::Text("Last preload: %zu images, %zu sounds, %zu fonts (decode %.1f ms, upload %.1f ms)",
+            AssetPreloader::lastImages, AssetPreloader::lastSounds, AssetPreloader::lastFonts,
+            AssetPreloader::lastDecodeMs, AssetPreloader::lastUploadMs);
+
+        renderTopStats("Engine sections", sections, 16);
+        renderTopStats("Component types", componentTypes, 10);
+        renderTopStats("Actors", actors, 10);
+    }
+
+    ImGui::End();
+#endif
+}
+
+ProfileScope::ProfileScope(const char* sectionName) : name(sectionName), start(0), active(Profiler::enabled) {
+    if (active) {
+        start = Profiler::NowMicros();
+    }
+}
+
+ProfileScope::~ProfileScope() {
+    if (active) {
+        Profiler::AddSample(ProfileCategory::Section, name, start, Profiler::NowMicros() - start);
+    }
+}
@@ -0,0 +1,89 @@
+#include "headers/RenderQueue.h"
+#include <cmath>
+
+bool RenderQueue::sortByTexture = false;
+bool RenderQueue::cullOffscreen = true;
+uint64_t RenderQueue::frameCulled = 0;
+uint64_t RenderQueue::frameDrawn = 0;
+std::vector<RenderCommand> RenderQueue::commands;
+std::vector<uint64_t> RenderQueue::keys;
+std::vector<uint64_t> RenderQueue::scratchKeys;
+std::vector<uint32_t> RenderQueue::order;
+std::vector<uint32_t> RenderQueue::scratchOrder;
+
+void RenderQueue::PushUIEx(int imageId, float x, float y, float r, float g, float b, float a, int sortingOrder) {
+    RenderCommand command = RenderCommand::Make(RenderRequest::ImageType::UI, imageId, x, y, sortingOrder);
+    command.color = RenderCommand::PackColor(static_cast<int>(std::floor(r)), static_cast<int>(std::floor(g)), static_cast<int>(std::floor(b)), static_cast<int>(std::floor(a)));
+    Push(command);
+}
+
+void RenderQueue::PushSceneEx(int imageId, float x, float y, float rotation_degrees, float scale_x, float scale_y, float pivot_x, float pivot_y, float r, float g, float b, float a, int sortingOrder) {
+    RenderCommand command = RenderCommand::Make(RenderRequest::ImageType::Scene, imageId, x, y, sortingOrder);
+    command.rotationDegrees = static_cast<int>(rotation_degrees);
+    command.scaleX = scale_x;
+    command.scaleY = scale_y;
+    command.pivotX = pivot_x;
+    command.pivotY = pivot_y;
+    command.color = RenderCommand::PackColor(static_cast<int>(r), static_cast<int>(g), static_cast<int>(b), static_cast<int>(a));
+    Push(command);
+}
+
+static uint64_t makeKey(const RenderCommand& command, uint32_t index, bool sortByTexture) {
+    uint64_t key = static_cast<uint64_t>(command.type) << 62;
+    key |= static_cast<uint64_t>(static_cast<uint32_t>(command.sortingOrder) ^ 0x80000000u) << 30;
+
+    if (sortByTexture) {
+        uint64_t texture = static_cast<uint64_t>(command.imageId + 1);
+        if (texture > 0x3FF) texture = 0x3FF;
+        key |= (texture << 20) | (index & 0xFFFFF);
+    }
+    else {
+        key |= index & 0x3FFFFFFF;
+    }
+    return key;
+}
+
+const std::vector<uint32_t>& RenderQueue::Sort() {
+    size_t count = commands.size();
+    keys.resize(count);
+    order.resize(count);
+    scratchKeys.resize(count);
+    scratchOrder.resize(count);
+
+    // One pass builds the keys and the histograms for all eight bytes
+    uint32_t histograms[8][256] = {};
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t key = makeKey(commands[i], static_cast<uint32_t>(i), sortByTexture);
+        keys[i] = key;
+        order[i] = static_cast<uint32_t>(i);
+        for (int byte = 0; byte < 8; ++byte) {
+            histograms[byte][(key >> (byte * 8)) & 0xFF]++;
+        }
+    }
+
+    for (int byte = 0; byte < 8; ++byte) {
+        uint32_t* histogram = histograms[byte];
+
+        // Every key has the same value in this byte: nothing to reorder
+        if (count == 0 || histogram[(keys[0] >> (byte * 8)) & 0xFF] == count) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (int bucket = 0; bucket < 256; ++bucket) {
+            uint32_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t destination = histogram[(keys[i] >> (byte * 8)) & 0xFF]++;
+            scratchKeys[destination] = keys[i];
+            scratchOrder[destination] = order[i];
+        }
+        keys.swap(scratchKeys);
+        order.swap(scratchOrder);
+    }
+
+    return order;
+}
@@ -10,11 +10,31 @@
 #include "headers/Eventbus.h"
 #include "headers/RigidBody.h"
 #include "headers/GameManager.h"
+#include "headers/Headless.h"
+#include "headers/Profiler.h"
+#include "headers/ComponentDispatch.h"
+#include "headers/ActorRegistry.h"
+#include "headers/SpriteBatch.h"
+#include "headers/TextureAtlas.h"
+#include "headers/TextCache.h"
+#include "headers/GlyphAtlas.h"
+#include "headers/RenderQueue.h"
+#include "headers/ImageRegistry.h"
+#include "headers/PhysicsClock.h"
+#include "headers/PhysicsWorker.h"
+#include "headers/ActivityManager.h"
+#include "headers/ActorPool.h"
+#include "headers/SceneLoader.h"
+#include "headers/AssetPreloader.h"
+#include "headers/ImageDecoder.h"
+#include "headers/TextureBudget.h"
 #include <direct.h>  // Required for _mkdir on Windows
 #include <sys/stat.h>  // Required for mkdir on UNIX/Linux
 #include <sys/types.h>  // Additional types might be required
 #include <fstream>
 #include <map>
+#include <algorithm>
+#include <cmath>
 
 
 extern std::vector<std::shared_ptr<Actor>> hardcoded_actors;
@@ -31,6 +51,7 @@ float CameraBounds::cam_ease_factor;
 float CameraBounds::user_camera_x_pos, CameraBounds::user_camera_y_pos;
 
 extern std::string gamePlaying;
+extern bool presentVsync;
 
 Renderer::Renderer() :  windowWidth(640), windowHeight(360), clearColor{ 255, 255, 255, 255 }, windowTitle("") {
   
@@ -53,6 +74,9 @@ Renderer::~Renderer() {
 bool Renderer::Initialize() {
     LoadConfigurations();
     CreateWindowAndRenderer();
+#ifndef ENGINE_HEADLESS
+    TextureAtlas::Build(renderer); // before the initial scene's preload, which skips atlas images
+#endif
     return true;
 }
 
@@ -62,10 +86,47 @@ void Renderer::LoadConfigurations() {
     if (gameConfig.HasMember("game_title") && gameConfig["game_title"].IsString()) {
         windowTitle = gameConfig["game_title"].GetString();
     }
+    if (gameConfig.HasMember("physics_timestep") && gameConfig["physics_timestep"].IsNumber() && gameConfig["physics_timestep"].GetFloat() > 0.0f) {
+        PhysicsClock::fixedStep = gameConfig["physics_timestep"].GetFloat();
+    }
+    if (gameConfig.HasMember("physics_velocity_iterations") && gameConfig["physics_velocity_iterations"].IsInt()) {
+        PhysicsClock::velocityIterations = gameConfig["physics_velocity_iterations"].GetInt();
+    }
+    if (gameConfig.HasMember("physics_position_iterations") && gameConfig["physics_position_iterations"].IsInt()) {
+        PhysicsClock::positionIterations = gameConfig["physics_position_iterations"].GetInt();
+    }
+    if (gameConfig.HasMember("physics_max_substeps") && gameConfig["physics_max_substeps"].IsInt()) {
+        PhysicsClock::maxSubsteps = std::max(1, gameConfig["physics_max_substeps"].GetInt());
+    }
+    if (gameConfig.HasMember("physics_interpolation") && gameConfig["physics_interpolation"].IsBool()) {
+        PhysicsClock::interpolate = gameConfig["physics_interpolation"].GetBool();
+    }
+    if (gameConfig.HasMember("async_physics") && gameConfig["async_physics"].IsBool()) {
+        PhysicsWorker::enabled = gameConfig["async_physics"].GetBool();
+    }
+    if (gameConfig.HasMember("dormant_actors") && gameConfig["dormant_actors"].IsBool()) {
+        ActivityManager::dormantByDefault = gameConfig["dormant_actors"].GetBool();
+    }
+    if (gameConfig.HasMember("dormant_margin") && gameConfig["dormant_margin"].IsNumber()) {
+        ActivityManager::margin = gameConfig["dormant_margin"].GetFloat();
+    }
+    if (gameConfig.HasMember("async_load_budget_ms") && gameConfig["async_load_budget_ms"].IsNumber()) {
+        SceneLoader::stageBudgetMs = gameConfig["async_load_budget_ms"].GetDouble();
+    }
+    if (gameConfig.HasMember("preload_assets") && gameConfig["preload_assets"].IsBool()) {
+        AssetPreloader::enabled = gameConfig["preload_assets"].GetBool();
+    }
+    if (gameConfig.HasMember("image_decode_threads") && gameConfig["image_decode_threads"].IsInt()) {
+        ImageDecoder::Resize(static_cast<unsigned int>(std::max(0, gameConfig["image_decode_threads"].GetInt())));
+    }
+    if (gameConfig.HasMember("image_decode_queue") && gameConfig["image_decode_queue"].IsInt()) {
+        ImageDecoder::queueCapacity = static_cast<size_t>(std::max(1, gameConfig["image_decode_queue"].GetInt()));
+    }
 //    ImageDB::checkAllIntroImagesExists(gameConfig);
     TextDB::checkAllIntroFontsExists(gameConfig);
 
     rapidjson::Document renderingConfig;
+    TextureAtlas::enabled = true; // back on for each game unless its config says otherwise
     const std::filesystem::path configFile{ "resources/" + gamePlaying + "/rendering.config" };
     if (std::filesystem::exists(configFile)) {
 
@@ -93,6 +154,30 @@ void Renderer::LoadConfigurations() {
         if (renderingConfig.HasMember("clear_color_b") && renderingConfig["clear_color_b"].IsInt()) {
             clearColor.b = static_cast<Uint8>(renderingConfig["clear_color_b"].GetInt());
         }
+        if (renderingConfig.HasMember("text_cache_budget_kb") && renderingConfig["text_cache_budget_kb"].IsInt()) {
+            TextCache::budgetBytes = static_cast<size_t>(std::max(0, renderingConfig["text_cache_budget_kb"].GetInt())) * 1024;
+        }
+        if (renderingConfig.HasMember("texture_budget_mb") && renderingConfig["texture_budget_mb"].IsInt()) {
+            TextureBudget::budgetBytes = static_cast<size_t>(std::max(0, renderingConfig["texture_budget_mb"].GetInt())) * 1024 * 1024;
+        }
+        if (renderingConfig.HasMember("texture_idle_frames") && renderingConfig["texture_idle_frames"].IsInt()) {
+            TextureBudget::idleFrames = static_cast<uint64_t>(std::max(1, renderingConfig["texture_idle_frames"].GetInt()));
+        }
+        if (renderingConfig.HasMember("text_renderer") && renderingConfig["text_renderer"].IsString()) {
+            GlyphAtlas::enabled = std::string(renderingConfig["text_renderer"].GetString()) == "glyph_atlas";
+        }
+        if (renderingConfig.HasMember("sprite_batching") && renderingConfig["sprite_batching"].IsBool()) {
+            SpriteBatch::enabled = renderingConfig["sprite_batching"].GetBool();
+        }
+        if (renderingConfig.HasMember("texture_atlas") && renderingConfig["texture_atlas"].IsBool()) {
+            TextureAtlas::enabled = renderingConfig["texture_atlas"].GetBool();
+        }
+        if (renderingConfig.HasMember("sort_by_texture") && renderingConfig["sort_by_texture"].IsBool()) {
+            RenderQueue::sortByTexture = renderingConfig["sort_by_texture"].GetBool();
+        }
+        if (renderingConfig.HasMember("cull_offscreen") && renderingConfig["cull_offscreen"].IsBool()) {
+            RenderQueue::cullOffscreen = renderingConfig["cull_offscreen"].GetBool();
+        }
         
         clearColor.a = 255;
     }
@@ -136,6 +221,14 @@ void Renderer::RenderIntro(ImageDB& imageDB, TextDB& textDB, AudioDB& audioDB, s
 
 void Renderer::CreateWindowAndRenderer() {
 
+#ifdef ENGINE_HEADLESS
+    // Headless builds never open a window or create an SDL_Renderer / ImGui context.
+    // Only the event subsystem is brought up so SDL_GetTicks and friends keep working.
+    if (SDL_Init(SDL_INIT_EVENTS) != 0) {
+        std::cerr << "SDL could not initialize! SDL Error: " << SDL_GetError() << std::endl;
+        exit(0);
+    }
+#else
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         std::cerr << "SDL could not initialize! SDL Error: " << SDL_GetError() << std::endl;
         exit(0);
@@ -148,7 +241,7 @@ void Renderer::CreateWindowAndRenderer() {
         exit(0); // Or handle more gracefully
     }
 
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | (presentVsync ? SDL_RENDERER_PRESENTVSYNC : 0));
     if (!renderer) {
         std::cerr << "Renderer could not be created! SDL Error: " << SDL_GetError() << std::endl;
         exit(0); // Or handle more gracefully
@@ -175,7 +268,7 @@ void Renderer::CreateWindowAndRenderer() {
     style.Colors[ImGuiCol_Header] = ImVec4(0.2f, 0.205f, 0.21f, 1.0f);    // Background color for headers
     style.Colors[ImGuiCol_Button] = ImVec4(0.2f, 0.25f, 0.3f, 1.0f);      // Background color for buttons
     style.Colors[ImGuiCol_ButtonHovered] = ImVec4(0.3f, 0.305f, 0.31f, 1.0f); // Background color for button hover
-
+#endif
 }
 
 
@@ -184,6 +277,9 @@ SDL_Renderer* Renderer::getRenderer() {
     return renderer;
 }
 
+#ifndef ENGINE_HEADLESS
+static void resetResolvedSprites(); // next to the sprite batch helpers below
+
 static bool showCreateGameWindow = false;
 static int activeSubMenu = -1;
 static bool restartGame = false
@@ -293,10 +389,12 @@ void RenderGameCreationWindow() {
             ImGui::BulletText("GetComponents() - Retrieve all components attached to the actor.");
             ImGui::BulletText("Find(name) - Static function to find an actor by name.");
             ImGui::BulletText("FindAll(name) - Static function to find all actors by name.");
+            ImGui::BulletText("SetFindAllCaching(enabled) - Reuse FindAll results until actors with that name change.");
             ImGui::BulletText("AddComponent(component) - Add a component to the actor from Lua.");
             ImGui::BulletText("RemoveComponent(component) - Remove a component from the actor from Lua.");
             ImGui::BulletText("Instantiate() - Static function to create a new actor instance.");
             ImGui::BulletText("Destroy() - Static function to destroy an actor.");
+            ImGui::BulletText("GetPoolStats(template) - available/in_use/created/reused counts for a pooled template, or nil.");
 
             ImGui::Text("These bindings allow Lua scripts to directly manipulate game objects.");
         }
@@ -313,6 +411,7 @@ void RenderGameCreationWindow() {
             ImGui::BulletText("Sleep(milliseconds) - Delays the application for a specified number of milliseconds.");
             ImGui::BulletText("GetFrame() - Returns the current frame count since the application started.");
             ImGui::BulletText("OpenURL(url) - Opens a URL in the default web browser.");
+            ImGui::BulletText("GetPreloadStats() - Returns timings and counts of the last scene asset preload.");
 
             ImGui::Text("These functions provide basic application control and utility features accessible from Lua scripts.");
         }
@@ -419,6 +518,7 @@ void RenderGameCreationWindow() {
             ImGui::TextColored(ImVec4(0.5, 0.8, 0.1, 1), "Image.DrawUI('logo', 100, 200, 300, 150)");
             ImGui::TextColored(ImVec4(0.5, 0.8, 0.1, 1), "Image.DrawEx('sprite', 400, 300, 1.5, 1.5, 90, {255, 255, 255, 255})");
             ImGui::TextColored(ImVec4(0.5, 0.8, 0.1, 1), "Image.DrawPixel(500, 500, {0, 255, 0, 255})");
+            ImGui::TextColored(ImVec4(0.5, 0.8, 0.1, 1), "local id = Image.Load('sprite'); Image.DrawById(id, 400, 300)");
 
             ImGui::Text("These methods are integral for creating and managing dynamic visual content within the game, offering extensive control over graphics rendering.");
         }
@@ -460,6 +560,8 @@ void RenderGameCreationWindow() {
 
             // Detailed explanations
             ImGui::BulletText("Load(sceneName) - Loads a new scene, transitioning from the current scene.");
+            ImGui::BulletText("LoadAsync(sceneName) - Loads the scene in the background and switches to it once it is ready.");
+            ImGui::BulletText("GetLoadProgress() / IsLoading() - Progress (0 to 1) of the background load, for loading screens.");
             ImGui::BulletText("GetCurrent() - Returns the name of the current active scene.");
             ImGui::BulletText("DontDestroy(object) - Marks an object to not be destroyed when loading a new scene.");
 
@@ -492,6 +594,11 @@ void RenderGameCreationWindow() {
             ImGui::BulletText("width, height, radius - Dimensions of the Rigidbody's collider.");
             ImGui::BulletText("bounciness - The restitution coefficient of the Rigidbody.");
             ImGui::BulletText("friction - The friction coefficient of the Rigidbody.");
+            ImGui::BulletText("layer, collides_with - Collision layer name and the comma-separated layers it collides with.");
+            ImGui::BulletText("collision_group - Bodies sharing a negative group never collide, a positive one always do.");
+            ImGui::BulletText("IsAwake() / SetAwake(awake) - Box2D sleep state of the body.");
+            ImGui::BulletText("SetSleepingAllowed(allowed) / IsSleepingAllowed() - Whether Box2D may put the body to sleep.");
+            ImGui::BulletText("can_go_dormant - Skip the actor's OnUpdate/OnLateUpdate while the body sleeps off-screen.");
             ImGui::BulletText("trigger_type, trigger_width, trigger_height, trigger_radius - Properties defining trigger areas if any.");
 
             // Methods Explanations
@@ -564,6 +671,12 @@ void RenderGameCreationWindow() {
             ImGui::Text("Physics Class:");
             ImGui::BulletText("Raycast(startPoint, endPoint) - Performs a raycast from start to end point, returning a HitResult.");
             ImGui::BulletText("RaycastAll(startPoint, endPoint) - Performs a raycast that returns all hits along the ray's path.");
+            ImGui::BulletText("RaycastBatch(origins, dirs, dists, results) - Casts many rays at once; pass the returned table back in to reuse it.");
+            ImGui::BulletText("CircleCast(origin, radius, dir, dist) / BoxCast(origin, size, dir, dist) - Sweeps a shape and returns the first HitResult.");
+            ImGui::BulletText("OverlapCircle(center, radius) - Returns a table of the actors touching the circle.");
+            ImGui::BulletText("OverlapBox(center, size) - Returns a table of the actors touching the axis-aligned box.");
+            ImGui::BulletText("Nearest(pos, name) - Returns the closest actor with that name, or nil.");
+            ImGui::BulletText("Track(actor, pos) / Untrack(actor) - Places an actor without a Rigidbody in the overlap queries.");
 
             ImGui::Text("Example usage in Lua:");
             ImGui::TextColored(ImVec4(0.5, 0.8, 0.1, 1), "local hit = Physics.Raycast({x=0, y=0}, {x=100, y=100})");
@@ -694,13 +807,21 @@ void Renderer::RenderFolderSelection() {
         }
        
         gamePlaying = GameManager::folderList[selectedFolderIndex];
+        PhysicsWorker::Wait(); // a background step may still be recording contacts into CollisionEvents
         Actor::clearAll();
-        hardcoded_actors.clear();
+        ActorRegistry::Clear();
         AudioDB::clearAll();
         EventBus::clearAll();
         ImageDB::clearAll();
+        TextureAtlas::Clear();
+        resetResolvedSprites();
         LuaHelper::component_tables.clear();
+        SceneLoader::Clear();
+        AssetPreloader::Clear();
         TemplateDB::templates.clear();
+        ActorPool::Clear();
+        TextCache::Clear();
+        GlyphAtlas::Clear();
         TextDB::fontCache.clear();
 
         if (hpTexture) {
@@ -729,6 +850,7 @@ void Renderer::RenderFolderSelection() {
           
         // Word removal
         RigidBody::world = nullptr;
+        PhysicsClock::Reset();
 
         LoadConfigurations();
         if (SDL_Init(SDL_INIT_VIDEO) != 0) {
@@ -743,7 +865,7 @@ void Renderer::RenderFolderSelection() {
             exit(0); // Or handle more gracefully
         }
 
-        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | (presentVsync ? SDL_RENDERER_PRESENTVSYNC : 0));
         if (!renderer) {
             std::cerr << "Renderer could not be created! SDL Error: " << SDL_GetError() << std::endl;
             exit(0); // Or handle more gracefully
@@ -752,6 +874,8 @@ void Renderer::RenderFolderSelection() {
 
         LuaHelper::loadAndCacheAllBaseTables();
         Scene::sparseSceneFile(sceneFilePath, hardcoded_actors);
+        TextureAtlas::Build(renderer);
+        AssetPreloader::PreloadScene(sceneFilePath, renderer);
         CameraBounds::Intialize();
         // Get all the views
         CameraBounds::calculateCameraPositions(camera_offset_x, camera_offset_y);
@@ -975,6 +1099,7 @@ void Renderer::ProcessInput(glm::vec2 &movementDirection) {
     ImGui::NewFrame();
 
     RenderImGui(); // Your ImGui rendering function
+    Profiler::RenderImGui();
     RenderCreateGames();
     RenderFolderSelection();
     RenderGameCreationWindow();
@@ -989,6 +1114,7 @@ void Renderer::ProcessInput(glm::vec2 &movementDirection) {
 
     if (gameState == Game::Paused) { SDL_RenderPresent(renderer); }
 }
+#endif // ENGINE_HEADLESS
 
 void printLuaRefValue(const luabridge::LuaRef& ref) {
     if (!ref.isNil()) { // Check if the LuaRef is not nil
@@ -1034,58 +1160,14 @@ void ReportError(const std::string& actor_name, const luabridge::LuaException& e
 void Renderer::RenderActors(float& cam_x_pos, float& cam_y_pos, float &zoom_factor) {
     const int PIXELS_PER_UNIT = 100; // 100 pixels represent one in-game unit
 
-
-    for (auto& actor : hardcoded_actors) {
-        for (const auto& [key, componentRef] : actor->actor_components) {
-
-            try {
-                // Call OnStart if it's the first frame
-                if (!(*componentRef)["OnStartOver"].cast<bool>() && (*componentRef)["enabled"].cast<bool>() && (*componentRef)["OnStart"].cast<bool>() && (*componentRef)["OnStart"].isFunction()) {
-                    (*componentRef)["OnStart"](*componentRef);
-                    (*componentRef)["OnStartOver"] = true;
-                }
-
-            }
-            catch (const luabridge::LuaException& e) {
-                ReportError(actor->actor_name, e);
-                (*componentRef)["OnStartOver"] = true;
-            }
-        }
-    }
-    
-
-    // OnUpdate pass
-    for (auto& actor : hardcoded_actors) {
-        for (const auto& [key, componentRef] : actor->actor_components) {
-            try {
-                if ((*componentRef)["enabled"].cast<bool>() && (*componentRef)["OnUpdate"].isFunction()) {
-                    (*componentRef)["OnUpdate"](*componentRef);
-                }
-            }
-            catch (const luabridge::LuaException& e) {
-                ReportError(actor->actor_name, e);
-            }
-        }
-    }
-
-    // OnLateUpdate pass
-    for (auto& actor : hardcoded_actors) {
-        for (const auto& [key, componentRef] : actor->actor_components) {
-            try {
-                if ((*componentRef)["enabled"].cast<bool>() && (*componentRef)["OnLateUpdate"].isFunction()) {
-                    (*componentRef)["OnLateUpdate"](*componentRef);
-                }
-            }
-            catch (const luabridge::LuaException& e) {
-                ReportError(actor->actor_name, e);
-            }
-        }
-    }
-
+    ComponentDispatch::RunOnStart();
+    // Half the view in world units, for deciding which sleeping actors are off-screen
+    ActivityManager::Update(windowWidth * 0.5f / (zoom_factor * PIXELS_PER_UNIT), windowHeight * 0.5f / (zoom_factor * PIXELS_PER_UNIT));
+    ComponentDispatch::RunOnUpdate();
+    ComponentDispatch::RunOnLateUpdate();
 }
 
 
-
 void Renderer::RenderHUD(const std::string& hpImagePath, TextDB& textDB, std::vector<std::pair<int, std::string>>& dialogueEntries) {
    
     int hpImageWidth, hpImageHeight;
@@ -1109,45 +1191,247 @@ void Renderer::RenderHUD(const std::string& hpImagePath, TextDB& textDB, std::ve
 }
 
 
-void Renderer::RenderFrame() {
+// Destination rectangle (in unzoomed pixels) and rotation pivot of a scene image
+static void computeSceneImageRect(float x, float y, float scale_x, float scale_y, float pivot_x, float pivot_y, int textureWidth, int textureHeight, int windowWidth, int windowHeight, SDL_Rect& destRect, SDL_Point& rotationCenter) {
+    float pivotX;
+    float pivotY;
+    
+    if (pivot_x == -1) {
+        pivotX = static_cast<int>(textureWidth * 0.5);
+    }
+    else {
+        pivotX = static_cast<int>(pivot_x * textureWidth * scale_x);
+    }
 
-    bool textDone = false;
+    if (pivot_y == -1) {
+        pivotY = static_cast<int>(textureHeight * 0.5);
+    }
+    else {
+        pivotY = static_cast<int>(pivot_y * textureHeight * scale_y);
+    }
+  
+    // Should just take from Camera
+    int halfWidth = windowWidth / 2;
+    int halfHeight = windowHeight / 2;
+
+    const int PIXELS_PER_UNIT = 100;
+    // Then apply the camera adjustments after calculating the pivot
+    destRect = {
+        static_cast<int>(halfWidth / CameraBounds::zoom_factor + (x - CameraBounds::cam_x_pos) * PIXELS_PER_UNIT - (pivotX)),
+        static_cast<int>(halfHeight / CameraBounds::zoom_factor + (y - CameraBounds::cam_y_pos) * PIXELS_PER_UNIT - (pivotY)),
+        static_cast<int>(textureWidth * fabs(scale_x)),
+        static_cast<int>(textureHeight * fabs(scale_y))
+    };
+
+    // Rotation center: SDL_Point represents the point around which to rotate; 
+    rotationCenter = { static_cast<int>(pivotX), static_cast<int>(pivotY) };
+}
 
-    std::stable_sort(ImageDB::requests.begin(), ImageDB::requests.end(), [](const RenderRequest& a, const RenderRequest& b) {
-        if (a.type != b.type) return a.type < b.type;
-        return a.sorting_order < b.sorting_order;
-        });
+// Whether a scene image placed by computeSceneImageRect can touch the screen.
+// Everything is in unzoomed pixels, where the screen spans window size / zoom.
+// Rotated images are tested with the circle around the pivot that holds every
+// rotation, so the test never rejects a visible sprite. Updates the counters.
+static bool sceneImageVisible(const SDL_Rect& destRect, const SDL_Point& rotationCenter, int rotationDegrees, int windowWidth, int windowHeight) {
+    if (!RenderQueue::cullOffscreen) {
+        RenderQueue::frameDrawn++;
+        return true;
+    }
+
+    float left = static_cast<float>(destRect.x);
+    float top = static_cast<float>(destRect.y);
+    float right = left + destRect.w;
+    float bottom = top + destRect.h;
+
+    if (rotationDegrees % 360 != 0) {
+        float pivotX = left + rotationCenter.x;
+        float pivotY = top + rotationCenter.y;
+        float farX = std::max(std::fabs(left - pivotX), std::fabs(right - pivotX));
+        float farY = std::max(std::fabs(top - pivotY), std::fabs(bottom - pivotY));
+        float radius = std::sqrt(farX * farX + farY * farY);
+        left = pivotX - radius;
+        right = pivotX + radius;
+        top = pivotY - radius;
+        bottom = pivotY + radius;
+    }
+
+    float viewWidth = windowWidth / CameraBounds::zoom_factor;
+    float viewHeight = windowHeight / CameraBounds::zoom_factor;
+    if (right < 0.0f || bottom < 0.0f || left > viewWidth || top > viewHeight) {
+        RenderQueue::frameCulled++;
+        return false;
+    }
+
+    RenderQueue::frameDrawn++;
+    return true;
+}
+
+#ifndef ENGINE_HEADLESS
+// Texture and source rect for a sprite: its atlas page if it was packed, else its own ImageDB texture
+struct SpriteSource {
+    SDL_Texture* texture;
+    const SDL_Rect* srcRect;
+    int imageWidth, imageHeight;
+    int textureWidth, textureHeight;
+};
+
+// Resolved sources indexed by image id, so steady-state frames do no string hashing.
+// Cleared whenever the textures they point at are (game switch, TextureBudget eviction).
+static std::vector<SpriteSource> resolvedSprites;
+static uint64_t resolvedGeneration = 0;
+
+static void resetResolvedSprites() {
+    resolvedSprites.clear();
+}
+
+static bool resolveSprite(SDL_Renderer* renderer, int imageId, SpriteSource& source) {
+    if (resolvedGeneration != TextureBudget::Generation()) {
+        resolvedSprites.clear();
+        resolvedGeneration = TextureBudget::Generation();
+    }
+    if (imageId >= 0 && imageId < static_cast<int>(resolvedSprites.size()) && resolvedSprites[imageId].texture) {
+        source = resolvedSprites[imageId];
+        if (!source.srcRect) {
+            TextureBudget::Touch(imageId); // an ImageDB texture rather than an atlas page
+        }
+        return true;
+    }
+
+    const std::string* imageName = ImageRegistry::NameOf(imageId);
+    if (!imageName) {
+        return false;
+    }
+
+    if (const AtlasRegion* region = TextureAtlas::Find(*imageName)) {
+        source = { region->page, &region->rect, region->rect.w, region->rect.h, region->pageWidth, region->pageHeight };
+    }
+    else {
+        SDL_Texture* texture = ImageDB::loadImage(*imageName, renderer);
+        if (!texture) {
+            return false;
+        }
+        source = { texture, nullptr, 0, 0, 0, 0 };
+        SDL_QueryTexture(texture, NULL, NULL, &source.imageWidth, &source.imageHeight);
+        source.textureWidth = source.imageWidth;
+        source.textureHeight = source.imageHeight;
+    }
+
+    if (imageId >= static_cast<int>(resolvedSprites.size())) {
+        resolvedSprites.resize(imageId + 1, { nullptr, nullptr, 0, 0, 0, 0 });
+    }
+    resolvedSprites[imageId] = source;
+    return true;
+}
+
+// Queues a scene image into the sprite batch; same placement as Renderer::renderImage
+static void batchSceneImage(SDL_Renderer* renderer, const RenderCommand& command, int windowWidth, int windowHeight) {
+    SpriteSource source;
+    if (!resolveSprite(renderer, command.imageId, source)) {
+        return; // Texture not found, skip rendering
+    }
+
+    SDL_Rect destRect;
+    SDL_Point rotationCenter;
+    computeSceneImageRect(command.x, command.y, command.scaleX, command.scaleY, command.pivotX, command.pivotY,
+        source.imageWidth, source.imageHeight, windowWidth, windowHeight, destRect, rotationCenter);
+    if (!sceneImageVisible(destRect, rotationCenter, command.rotationDegrees, windowWidth, windowHeight)) {
+        return;
+    }
+
+    SDL_FPoint center = { static_cast<float>(rotationCenter.x), static_cast<float>(rotationCenter.y) };
+    SDL_Color color = { command.R(), command.G(), command.B(), command.A() };
+    SpriteBatch::Add(renderer, source.texture, source.srcRect, source.textureWidth, source.textureHeight, destRect, center,
+        static_cast<float>(command.rotationDegrees), CameraBounds::zoom_factor, color);
+}
+
+// Queues a UI image into the sprite batch; same placement as Renderer::renderUI
+static void batchUIImage(SDL_Renderer* renderer, const RenderCommand& command) {
+    SpriteSource source;
+    if (!resolveSprite(renderer, command.imageId, source)) return; // Texture not found, skip rendering
 
-    for (const auto& request : ImageDB::requests) {
-        switch (request.type) {
+    SDL_Rect destRect = { static_cast<int>(command.x), static_cast<int>(command.y), source.imageWidth, source.imageHeight };
+
+    SDL_Color color = { command.R(), command.G(), command.B(), command.A() };
+    SpriteBatch::Add(renderer, source.texture, source.srcRect, source.textureWidth, source.textureHeight, destRect, { 0.0f, 0.0f }, 0.0f, 1.0f, color);
+}
+
+// The unbatched paths and drawPixel still take a RenderRequest
+static RenderRequest toRenderRequest(const RenderCommand& command) {
+    const std::string* imageName = ImageRegistry::NameOf(command.imageId);
+    RenderRequest request(command.type, imageName ? *imageName : "", command.x, command.y, command.sortingOrder);
+    request.rotation_degrees = command.rotationDegrees;
+    request.scale_x = command.scaleX;
+    request.scale_y = command.scaleY;
+    request.pivot_x = command.pivotX;
+    request.pivot_y = command.pivotY;
+    request.r = command.R();
+    request.g = command.G();
+    request.b = command.B();
+    request.a = command.A();
+    return request;
+}
+#endif // ENGINE_HEADLESS
+
+void Renderer::RenderFrame() {
+    ProfileScope scope("Renderer::RenderFrame");
+
+#ifdef ENGINE_HEADLESS
+    // Nothing to draw into: record what would have been submitted and drop it.
+    Headless::RecordImageCommands(RenderQueue::Size());
+    RenderQueue::Clear();
+    TextDB::RenderAllText(getRenderer());
+#else
+    bool textDone = false;
+    SpriteBatch::frameBatches = 0;
+    SpriteBatch::frameSprites = 0;
+    RenderQueue::frameCulled = 0;
+    RenderQueue::frameDrawn = 0;
+
+    const std::vector<RenderCommand>& commands = RenderQueue::Commands();
+    for (uint32_t index : RenderQueue::Sort()) {
+        const RenderCommand& command = commands[index];
+        switch (command.type) {
 
         case RenderRequest::ImageType::Scene:
-            renderImage(request);
+            if (SpriteBatch::enabled) {
+                batchSceneImage(getRenderer(), command, windowWidth, windowHeight);
+            }
+            else {
+                renderImage(toRenderRequest(command));
+            }
             break;
 
         case RenderRequest::ImageType::UI:
-            renderUI(request);
+            if (SpriteBatch::enabled) {
+                batchUIImage(getRenderer(), command);
+            }
+            else {
+                renderUI(toRenderRequest(command));
+            }
             break;
             
         case RenderRequest::ImageType::Pixel:
+            SpriteBatch::Flush(getRenderer());
             if (!textDone) {
                 TextDB::RenderAllText(getRenderer());
                 textDone = true;
             }
 
-            drawPixel(request);
+            drawPixel(toRenderRequest(command));
             break;
         }   
     }
 
+    SpriteBatch::Flush(getRenderer());
     if (!textDone) {
         TextDB::RenderAllText(getRenderer());
         textDone = true;
     }
    
-    ImageDB::requests.clear();
+    RenderQueue::Clear();
+#endif
 }
 
+// Unbatched path (SpriteBatch::enabled off): one SDL_RenderCopyEx per request
 void Renderer::renderImage(const RenderRequest& request) {
 
     SDL_RenderSetScale(renderer, CameraBounds::zoom_factor, CameraBounds::zoom_factor);
@@ -1160,44 +1444,20 @@ void Renderer::renderImage(const RenderRequest& request) {
     // Query the texture size
     int textureWidth, textureHeight;
     SDL_QueryTexture(texture, NULL, NULL, &textureWidth, &textureHeight);
-    
-    float pivotX;
-    float pivotY;
-    
-    if (request.pivot_x == -1) {
-        pivotX = static_cast<int>(textureWidth * 0.5);
-    }
-    else {
-        pivotX = static_cast<int>(request.pivot_x * textureWidth * request.scale_x);
-    }
 
-    if (request.pivot_y == -1) {
-        pivotY = static_cast<int>(textureHeight * 0.5);
+    SDL_Rect destRect;
+    SDL_Point rotationCenter;
+    computeSceneImageRect(request.x, request.y, static_cast<float>(request.scale_x), static_cast<float>(request.scale_y), request.pivot_x, request.pivot_y,
+        textureWidth, textureHeight, windowWidth, windowHeight, destRect, rotationCenter);
+    if (!sceneImageVisible(destRect, rotationCenter, request.rotation_degrees, windowWidth, windowHeight)) {
+        SDL_RenderSetScale(renderer, 1, 1);
+        return;
     }
-    else {
-        pivotY = static_cast<int>(request.pivot_y * textureHeight * request.scale_y);
-    }
-  
-    // Should just take from Camera
-    int halfWidth = windowWidth / 2;
-    int halfHeight = windowHeight / 2;
-
-    const int PIXELS_PER_UNIT = 100;
-    // Then apply the camera adjustments after calculating the pivot
-    SDL_Rect destRect = {
-        static_cast<int>(halfWidth / CameraBounds::zoom_factor + (request.x - CameraBounds::cam_x_pos) * PIXELS_PER_UNIT - (pivotX)),
-        static_cast<int>(halfHeight / CameraBounds::zoom_factor + (request.y - CameraBounds::cam_y_pos) * PIXELS_PER_UNIT - (pivotY)),
-        static_cast<int>(textureWidth * fabs(request.scale_x)),
-        static_cast<int>(textureHeight * fabs(request.scale_y))
-    };
 
     // Set texture color modulation and alpha
     SDL_SetTextureColorMod(texture, request.r, request.g, request.b);
     SDL_SetTextureAlphaMod(texture, request.a);
 
-    // Rotation center: SDL_Point represents the point around which to rotate; 
-    SDL_Point rotationCenter = { static_cast<int>(pivotX), static_cast<int>(pivotY) };
-
     // Render the texture with rotation and flip
 //    SDL_RenderCopyEx(getRenderer(), texture, NULL, &destRect, request.rotation_degrees, &rotationCenter, SDL_FLIP_NONE);
     Helper::SDL_RenderCopyEx498(0, "", getRenderer(), texture, NULL, &destRect, request.rotation_degrees, &rotationCenter, SDL_FLIP_NONE);
@@ -1,4 +1,9 @@
 #include "headers/RigidBody.h"
+#include "headers/Profiler.h"
+#include "headers/PhysicsClock.h"
+#include "headers/CollisionEvents.h"
+#include "headers/CollisionFilters.h"
+#include "headers/ActivityManager.h"
 
 b2World* RigidBody::world;
 
@@ -36,9 +41,11 @@ void RigidBody::InitializeWorld() {
 }
 
 void RigidBody::Step() {
+    ProfileScope scope("RigidBody::Step");
     if (world)
     {
-        world->Step(1.0f / 60.0f, 8, 3);
+        PhysicsClock::Advance(world);
+        CollisionEvents::Dispatch();
     }
 }
 
@@ -60,6 +67,7 @@ void RigidBody::OnStart() {
 
     // Create the body in the Box2D world
     m_body = world->CreateBody(&bodyDef);
+    PhysicsClock::Forget(m_body); // may reuse a destroyed body's address
 
     // Define a box shape for our body
     b2PolygonShape boxShape;
@@ -78,12 +86,15 @@ void RigidBody::OnStart() {
 
         // Because it is a sensor (with no callback even), no collisions will ever occur
         phantom_fixture_def.isSensor = true;
+        // and with an empty mask it never even makes broadphase pairs
+        phantom_fixture_def.filter.maskBits = 0;
 
         //phantom_fixture_def.userData.pointer = reinterpret_cast<uintptr_t>(actor);
 
         m_body->CreateFixture(&phantom_fixture_def);
 
     }
+    b2Filter filter = CollisionFilters::FilterFor(this);
     if (has_collider) {
         if (collider_type == "box") {
             b2PolygonShape boxShape;
@@ -96,6 +107,7 @@ void RigidBody::OnStart() {
             fixtureDef.restitution = bounciness;
             fixtureDef.isSensor = false;
             fixtureDef.userData.pointer = reinterpret_cast<uintptr_t>(actor);
+            fixtureDef.filter = filter;
             m_body->CreateFixture(&fixtureDef);
         }
         else if (collider_type == "circle") {
@@ -109,6 +121,7 @@ void RigidBody::OnStart() {
             fixtureDef.restitution = bounciness;
             fixtureDef.isSensor = false;
             fixtureDef.userData.pointer = reinterpret_cast<uintptr_t>(actor);
+            fixtureDef.filter = filter;
             m_body->CreateFixture(&fixtureDef);
         }
     }
@@ -124,6 +137,7 @@ void RigidBody::OnStart() {
             triggerFixtureDef.friction = friction;
             triggerFixtureDef.restitution = bounciness;
             triggerFixtureDef.userData.pointer = reinterpret_cast<uintptr_t>(actor); 
+            triggerFixtureDef.filter = filter;
 
             m_body->CreateFixture(&triggerFixtureDef);
         }
@@ -139,12 +153,15 @@ void RigidBody::OnStart() {
             triggerFixtureDef.friction = friction;
             triggerFixtureDef.restitution = bounciness;
             triggerFixtureDef.userData.pointer = reinterpret_cast<uintptr_t>(actor); 
+            triggerFixtureDef.filter = filter;
 
             m_body->CreateFixture(&triggerFixtureDef); 
         }
     }
 
-
+    if (actor) {
+        ActivityManager::Register(actor, this);
+    }
 }
 
 float RigidBody::convert_rad_to_deg(float rad)
@@ -164,7 +181,7 @@ b2Vec2 RigidBody::toB2Vec2(const Vector2& vector) const {
 
 Vector2 RigidBody::GetPosition() {
     if (m_body != nullptr) { // Check if the physics body has been created
-        b2Vec2 pos = m_body->GetPosition();
+        b2Vec2 pos = PhysicsClock::InterpolatedPosition(m_body);
         return Vector2{ pos.x, pos.y };
     }
     return Vector2(x, y); // Return stored position if m_body is not available
@@ -173,7 +190,7 @@ Vector2 RigidBody::GetPosition() {
 
 float RigidBody::GetRotation() {
     if (m_body != nullptr) {
-        return convert_rad_to_deg(m_body->GetAngle());
+        return convert_rad_to_deg(PhysicsClock::InterpolatedAngle(m_body));
     }
     return rotation; // Return stored rotation if m_body is not available
 }
@@ -195,6 +212,7 @@ void RigidBody::SetVelocity(const Vector2& velocity) {
 void RigidBody::SetPosition(const Vector2& position) {
     if (m_body != nullptr) {
         m_body->SetTransform(toB2Vec2(position), m_body->GetAngle());
+        PhysicsClock::Forget(m_body);
     }
     else {
         x = position.getX(); // Store the position if m_body is not available
@@ -205,6 +223,7 @@ void RigidBody::SetPosition(const Vector2& position) {
 void RigidBody::SetRotation(float degreesClockwise) {
     if (m_body != nullptr) {
         m_body->SetTransform(m_body->GetPosition(), convert_deg_to_rad(degreesClockwise));
+        PhysicsClock::Forget(m_body);
     }
     else {
         rotation = degreesClockwise; // Store the rotation if m_body is not available
@@ -229,6 +248,7 @@ void RigidBody::SetUpDirection(const Vector2& direction) {
         Vector2 normalizedDirection = direction;
         normalizedDirection.Normalize();
         m_body->SetTransform(m_body->GetPosition(), glm::atan(normalizedDirection.getX(), -normalizedDirection.getY()));
+        PhysicsClock::Forget(m_body);
     }
 }
 
@@ -237,6 +257,7 @@ void RigidBody::SetRightDirection(const Vector2& direction) {
         Vector2 normalizedDirection = direction;
         normalizedDirection.Normalize();
         m_body->SetTransform(m_body->GetPosition(), (glm::atan(normalizedDirection.getX(), -normalizedDirection.getY()) - (b2_pi / 2.0)));
+        PhysicsClock::Forget(m_body);
     }
 }
 
@@ -1,10 +1,13 @@
 
 #include "headers/Scene.h"
 #include "headers/RigidBody.h"
-
-// Initialize region sizes with zero to begin with.
-extern glm::vec2 REGION_SIZE_COLLISION;
-extern glm::vec2 REGION_SIZE_TRIGGER;
+#include "headers/PhysicsClock.h"
+#include "headers/ActorRegistry.h"
+#include "headers/ActivityManager.h"
+#include "headers/CookedAsset.h"
+#include "headers/SceneLoader.h"
+#include "headers/AssetPreloader.h"
+#include "headers/TextureBudget.h"
 
 std::string Scene::currentScene;
 std::string Scene::nextScene;
@@ -50,8 +53,26 @@ void Scene::verifyComponentType(const std::string& type) {
 
 
 
+// Cooked counterpart of the JSON loop below. Component types are verified once
+// per scene instead of once per component.
+static void sparseCookedScene(const CookedAsset& cooked, std::vector<std::shared_ptr<Actor>>& hardcoded_actors) {
+    const Cooked::Header& header = cooked.GetHeader();
+    hardcoded_actors.reserve(header.actorCount);
+    std::vector<bool> verified(header.stringCount, false);
+
+    for (uint32_t a = 0; a < header.actorCount; ++a) {
+        ActorRegistry::Add(SceneLoader::BuildActor(cooked, a, verified));
+    }
+}
+
 void Scene::sparseSceneFile(const std::string& sceneFilePath, std::vector<std::shared_ptr<Actor>>& hardcoded_actors){
     
+    CookedAsset cooked;
+    if (cooked.Open(sceneFilePath)) {
+        sparseCookedScene(cooked, hardcoded_actors);
+        return;
+    }
+
     rapidjson::Document document;
     EngineUtils::ReadJsonFile(sceneFilePath, document);
        
@@ -150,7 +171,7 @@ void Scene::sparseSceneFile(const std::string& sceneFilePath, std::vector<std::s
         }
 
   
-        hardcoded_actors.push_back(actorInstance);
+        ActorRegistry::Add(actorInstance);
 
     }
    
@@ -169,6 +190,9 @@ bool Scene::isLoadScene(const std::string& sceneName) {
 
 
 void Scene::loadNewScene(const std::string& sceneName) {
+    if (sceneName != SceneLoader::PendingScene()) {
+        SceneLoader::Cancel();
+    }
     nextScene = sceneName;
     loadRequested = true;
 }
@@ -189,44 +213,66 @@ bool ActorExistsInQueue(const std::queue<std::shared_ptr<Actor>>& searchQueue, c
 void Scene::Update(Renderer &renderer) {
     if (loadRequested) {
         currentScene = nextScene;
-        hardcoded_actors.clear();
+        TextureBudget::BeginScene(currentScene);
 
-
-        auto it = hardcoded_actors.begin();
-        while (it != hardcoded_actors.end()) {
+        // The old scene is torn down while the registry still holds it
+        size_t index = 0;
+        while (index < hardcoded_actors.size()) {
+            std::shared_ptr<Actor> actor = hardcoded_actors[index];
             // Check if the current actor is in the dontKillMe queue
-            bool shouldSurvive = ActorExistsInQueue(dontKillMe, *it);
+            bool shouldSurvive = ActorExistsInQueue(dontKillMe, actor);
 
                 if (!shouldSurvive) {
                     // Call OnDestroy on all components of the actor
-                    for (const auto& [key, componentRef] : (*it)->actor_components) {
+                    for (const auto& [key, componentRef] : actor->actor_components) {
                         try {
                             if ((*componentRef)["OnDestroy"].isFunction()) {
                                 (*componentRef)["OnDestroy"](*componentRef);
-
-                                // If it's a Rigidbody, call the Box2D world's DestroyBody method
-                                if ((*componentRef)["type"].cast<std::string>() == "Rigidbody") {
-                                    RigidBody* rigidbody = (*componentRef).cast<RigidBody*>();
-                                    RigidBody::world->DestroyBody(rigidbody->m_body);
-                                }
                             }
                         }
                         catch (const luabridge::LuaException& e) {
-                            ReportError((*it)->actor_name, e);
+                            ReportError(actor->actor_name, e);
+                        }
+
+                        // Rigidbody has no OnDestroy; destroy its b2Body regardless
+                        if ((*componentRef)["type"].isString() && (*componentRef)["type"].cast<std::string>() == "Rigidbody") {
+                            PhysicsClock::DestroyBody((*componentRef).cast<RigidBody*>()->m_body);
                         }
                     }
 
-                    // After calling OnDestroy, remove the actor from the vector
-                    it = hardcoded_actors.erase(it);
+                    // After calling OnDestroy, remove the actor; the last actor is swapped into this index
+                    ActorRegistry::Remove(actor->GetID());
                 }
                 else {
                     // If the actor is not to be destroyed, move to the next one
-                    ++it;
+                    ++index;
                 }
         }
         
         std::queue<std::shared_ptr<Actor>>().swap(dontKillMe);
-        Scene::sparseSceneFile("resources/" + gamePlaying +  "/scenes/" + currentScene + ".scene", hardcoded_actors);
+
+        // Only the DontDestroyOnLoad survivors are left; start the registry over with them
+        std::vector<std::shared_ptr<Actor>> survivors = hardcoded_actors;
+        ActorRegistry::Clear();
+        for (const std::shared_ptr<Actor>& survivor : survivors) {
+            ActorRegistry::Add(survivor);
+            for (const auto& [key, componentRef] : survivor->actor_components) {
+                if ((*componentRef)["type"].isString() && (*componentRef)["type"].cast<std::string>() == "Rigidbody") {
+                    RigidBody* body = (*componentRef).cast<RigidBody*>();
+                    if (body->m_body) {
+                        ActivityManager::Register(survivor.get(), body); // Clear dropped it; OnStart will not run again
+                    }
+                }
+            }
+        }
+
+        if (!SceneLoader::Commit(currentScene, renderer)) {
+            std::string sceneFilePath = "resources/" + gamePlaying +  "/scenes/" + currentScene + ".scene";
+            size_t firstActor = hardcoded_actors.size(); // after the survivors, whose assets are loaded
+            Scene::sparseSceneFile(sceneFilePath, hardcoded_actors);
+            AssetPreloader::PreloadScene(sceneFilePath, renderer.getRenderer(), firstActor);
+        }
+        PhysicsClock::Resync(); // the load is not simulated time
         CameraBounds::calculateCameraPositions(renderer.camera_offset_x, renderer.camera_offset_y);
        // renderer.RenderActors(CameraBounds::cam_x_pos, CameraBounds::cam_y_pos, CameraBounds::zoom_factor);
     }
@@ -254,6 +300,12 @@ std::vector<std::shared_ptr<Actor>> FindAll(const std::string& name) {
 }
 
 void Scene::DontDestroyOnLoad(Actor* MainActor) {
+    if (std::shared_ptr<Actor> liveActor = ActorRegistry::GetShared(MainActor->id)) {
+        dontKillMe.push(liveActor);
+        return;
+    }
+
+    // Not live yet: it may still be waiting in deferredActorAdditions
     std::vector<std::shared_ptr<Actor>> actors = FindAll(MainActor->actor_name);
 
     for (const auto& actor : actors) {
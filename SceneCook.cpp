@@ -0,0 +1,46 @@
+// scene_cook: offline compiler for .scene and .template files (see CookedAsset.h).
+// Usage: scene_cook [directory ...]   (defaults to resources)
+#include "headers/CookedAsset.h"
+#define _SILENCE_EXPERIMENTAL_FILESYSTEM_DEPRECATION_WARNING
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> roots;
+    for (int i = 1; i < argc; ++i) {
+        roots.push_back(argv[i]);
+    }
+    if (roots.empty()) {
+        roots.push_back("resources");
+    }
+
+    int cooked = 0;
+    int failed = 0;
+    for (const std::string& root : roots) {
+        if (!std::filesystem::is_directory(root)) {
+            std::cout << "error: " << root << " is not a directory" << std::endl;
+            return 1;
+        }
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+            std::string extension = entry.path().extension().string();
+            if (!entry.is_regular_file() || (extension != ".scene" && extension != ".template")) {
+                continue;
+            }
+            if (CookedAsset::Cook(entry.path().string())) {
+                cooked++;
+            }
+            else {
+                failed++;
+            }
+        }
+    }
+
+    std::cout << "scene_cook: cooked " << cooked << " files";
+    if (failed > 0) {
+        std::cout << ", " << failed << " failed";
+    }
+    std::cout << std::endl;
+    return failed > 0 ? 1 : 0;
+}
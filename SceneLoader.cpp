@@ -0,0 +1,215 @@
+#include "headers/SceneLoader.h"
+#include "headers/Scene.h"
+#include "headers/Renderer.h"
+#include "headers/AssetPreloader.h"
+#include "headers/ActorRegistry.h"
+#include "headers/RigidBody.h"
+#include "headers/Template.h"
+#include "headers/Profiler.h"
+#define _SILENCE_EXPERIMENTAL_FILESYSTEM_DEPRECATION_WARNING
+#include <filesystem>
+#include <chrono>
+#include <unordered_set>
+
+double SceneLoader::stageBudgetMs = 4.0;
+std::string SceneLoader::sceneName;
+std::unique_ptr<SceneLoader::Prepared> SceneLoader::prepared;
+std::future<void> SceneLoader::worker;
+std::vector<std::shared_ptr<Actor>> SceneLoader::staged;
+std::vector<bool> SceneLoader::verified;
+bool SceneLoader::ready = false;
+std::atomic<uint32_t> SceneLoader::assetsTotal{ 0 };
+std::atomic<uint32_t> SceneLoader::assetsDone{ 0 };
+std::atomic<bool> SceneLoader::parsed{ false };
+std::atomic<bool> SceneLoader::decoded{ false };
+std::atomic<bool> SceneLoader::cancelled{ false };
+
+extern std::string gamePlaying;
+
+void SceneLoader::LoadAsync(const std::string& name) {
+    if (name == sceneName) {
+        return; // already on its way
+    }
+    Cancel();
+
+    std::string scenePath = "resources/" + gamePlaying + "/scenes/" + name + ".scene";
+    if (!std::filesystem::exists(scenePath) && !std::filesystem::exists(CookedAsset::CookedPath(scenePath))) {
+        std::cout << "error: scene " << name << " is missing";
+        std::exit(0);
+    }
+
+    sceneName = name;
+    prepared = std::make_unique<Prepared>();
+    assetsTotal = 0;
+    assetsDone = 0;
+    parsed = false;
+    decoded = false;
+    cancelled = false;
+    worker = std::async(std::launch::async, &SceneLoader::work, prepared.get(), scenePath, gamePlaying);
+}
+
+void SceneLoader::work(Prepared* target, std::string scenePath, std::string gameFolder) {
+    if (!target->scene.Load(scenePath)) {
+        return;
+    }
+    parsed = true;
+
+    if (AssetPreloader::enabled) {
+        AssetList assets = AssetPreloader::Collect(target->scene, scenePath, gameFolder);
+        assetsTotal = static_cast<uint32_t>(assets.images.size() + assets.sounds.size());
+        AssetPreloader::Decode(assets, target->assets, &cancelled, &assetsDone);
+    }
+    target->ok = true;
+    decoded = true;
+}
+
+void SceneLoader::Update() {
+    if (!prepared || ready) {
+        return;
+    }
+    if (worker.valid()) {
+        if (worker.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+        worker.get();
+        if (!prepared->ok) {
+            std::cout << "error: scene " << sceneName << " could not be loaded";
+            std::exit(0);
+        }
+        verified.assign(prepared->scene.GetHeader().stringCount, false);
+    }
+
+    ProfileScope scope("SceneLoader stage actors");
+    auto start = std::chrono::steady_clock::now();
+    uint32_t actorCount = prepared->scene.GetHeader().actorCount;
+    while (staged.size() < actorCount) {
+        staged.push_back(BuildActor(prepared->scene, static_cast<uint32_t>(staged.size()), verified));
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() >= stageBudgetMs) {
+            break;
+        }
+    }
+
+    if (staged.size() == actorCount) {
+        ready = true;
+        Scene::loadNewScene(sceneName);
+    }
+}
+
+std::shared_ptr<Actor> SceneLoader::BuildActor(const CookedAsset& scene, uint32_t index, std::vector<bool>& verifiedTypes) {
+    const Cooked::Actor& actor = scene.Actors()[index];
+    std::shared_ptr<Actor> actorInstance;
+
+    if (actor.templateName != Cooked::kNone) {
+        std::string templateName = scene.String(actor.templateName);
+        Actor* templateRawInstance = TemplateDB::getTemplate(templateName);
+        if (!templateRawInstance) {
+            TemplateDB::loadTemplate(templateName);
+            templateRawInstance = TemplateDB::getTemplate(templateName);
+            if (!templateRawInstance) {
+                std::cout << "error: template " << templateName << " is missing";
+                std::exit(0);
+            }
+        }
+        actorInstance = std::make_shared<Actor>(*templateRawInstance);
+        actorInstance->deepCopyComponentsFrom(*templateRawInstance);
+        if (actor.name != Cooked::kNone) {
+            actorInstance->actor_name = scene.String(actor.name);
+        }
+    }
+    else {
+        actorInstance = std::make_shared<Actor>(std::string(actor.name != Cooked::kNone ? scene.String(actor.name) : ""));
+    }
+
+    for (uint32_t c = 0; c < actor.componentCount; ++c) {
+        const Cooked::Component& component = scene.Components()[actor.firstComponent + c];
+        std::string key = scene.String(component.key);
+
+        if (component.type != Cooked::kNone) {
+            std::string componentName = scene.String(component.type);
+            if (!verifiedTypes[component.type]) {
+                if (componentName == "Rigidbody") {
+                    RigidBody::InitializeWorld();
+                }
+                else {
+                    Scene::verifyComponentType(componentName);
+                }
+                verifiedTypes[component.type] = true;
+            }
+            actorInstance->addComponent(key, componentName);
+        }
+
+        std::shared_ptr<luabridge::LuaRef> instanceRef = actorInstance->actor_components[key];
+        scene.ApplyProperties(component, *instanceRef);
+        actorInstance->InjectConvenienceReferences(instanceRef);
+    }
+    return actorInstance;
+}
+
+bool SceneLoader::Commit(const std::string& name, Renderer& renderer) {
+    if (!ready || name != sceneName) {
+        Cancel();
+        return false;
+    }
+    ProfileScope scope("SceneLoader commit");
+
+    for (const auto& actor : staged) {
+        ActorRegistry::Add(actor);
+    }
+
+    AssetPreloader::Upload(prepared->assets, renderer.getRenderer());
+
+    prepared.reset();
+    staged.clear();
+    verified.clear();
+    ready = false;
+    sceneName.clear();
+    return true;
+}
+
+void SceneLoader::Cancel() {
+    if (!prepared) {
+        return;
+    }
+    cancelled = true;
+    if (worker.valid()) {
+        worker.wait();
+        worker = std::future<void>();
+    }
+    AssetPreloader::Discard(prepared->assets);
+    prepared.reset();
+    staged.clear();
+    verified.clear();
+    ready = false;
+    sceneName.clear();
+}
+
+void SceneLoader::Clear() {
+    Cancel();
+}
+
+float SceneLoader::GetProgress() {
+    if (!prepared) {
+        return 1.0f;
+    }
+    if (ready) {
+        return 1.0f;
+    }
+
+    float parse = parsed ? 1.0f : 0.0f;
+    float assets = decoded ? 1.0f : (assetsTotal > 0 ? static_cast<float>(assetsDone) / assetsTotal : 0.0f);
+    float stage = 0.0f;
+    if (decoded && !worker.valid()) {
+        uint32_t actorCount = prepared->scene.GetHeader().actorCount;
+        stage = actorCount > 0 ? static_cast<float>(staged.size()) / actorCount : 1.0f;
+    }
+    return 0.1f * parse + 0.6f * assets + 0.3f * stage;
+}
+
+bool SceneLoader::IsLoading() {
+    return prepared != nullptr;
+}
+
+const std::string& SceneLoader::PendingScene() {
+    return sceneName;
+}
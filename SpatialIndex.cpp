@@ -0,0 +1,254 @@
+#include "headers/SpatialIndex.h"
+#include "headers/ActorRegistry.h"
+#include "headers/MainHelper.h"
+#include <algorithm>
+#include <cmath>
+
+float SpatialIndex::cellSize = 2.0f;
+std::unordered_map<uint64_t, std::vector<int>> SpatialIndex::cells;
+std::unordered_map<int, SpatialIndex::TrackedActor> SpatialIndex::tracked;
+
+namespace {
+    // Collects every fixture whose AABB overlaps the query AABB
+    class FixtureQueryCallback : public b2QueryCallback {
+    public:
+        bool ReportFixture(b2Fixture* fixture) override {
+            fixtures.push_back(fixture);
+            return true;
+        }
+
+        std::vector<b2Fixture*> fixtures;
+    };
+}
+
+std::vector<b2Fixture*> SpatialIndex::QueryFixtures(const b2AABB& bounds) {
+    FixtureQueryCallback callback;
+    if (RigidBody::world) {
+        RigidBody::world->QueryAABB(&callback, bounds);
+    }
+    return std::move(callback.fixtures);
+}
+
+// Composite key from two cell coordinates
+uint64_t SpatialIndex::cellKey(int cellX, int cellY) {
+    auto x_ = static_cast<uint32_t>(cellX);
+    auto y_ = static_cast<uint32_t>(cellY);
+    return (static_cast<uint64_t>(x_) << 32) | static_cast<uint64_t>(y_);
+}
+
+uint64_t SpatialIndex::cellOf(float x, float y) {
+    return cellKey(static_cast<int>(std::floor(x / cellSize)), static_cast<int>(std::floor(y / cellSize)));
+}
+
+void SpatialIndex::removeFromCell(uint64_t cell, int actorId) {
+    auto it = cells.find(cell);
+    if (it == cells.end()) {
+        return;
+    }
+
+    std::vector<int>& ids = it->second;
+    auto found = std::find(ids.begin(), ids.end(), actorId);
+    if (found != ids.end()) {
+        *found = ids.back();
+        ids.pop_back();
+    }
+    if (ids.empty()) {
+        cells.erase(it);
+    }
+}
+
+template <typename Visit>
+void SpatialIndex::forEachTrackedIn(float minX, float minY, float maxX, float maxY, Visit visit) {
+    if (tracked.empty()) {
+        return;
+    }
+
+    int firstX = static_cast<int>(std::floor(minX / cellSize));
+    int firstY = static_cast<int>(std::floor(minY / cellSize));
+    int lastX = static_cast<int>(std::floor(maxX / cellSize));
+    int lastY = static_cast<int>(std::floor(maxY / cellSize));
+
+    // A huge query would walk mostly empty cells; scan the entries instead
+    if (static_cast<int64_t>(lastX - firstX + 1) * (lastY - firstY + 1) > static_cast<int64_t>(tracked.size())) {
+        for (const auto& [id, entry] : tracked) {
+            visit(entry);
+        }
+        return;
+    }
+
+    for (int cellX = firstX; cellX <= lastX; ++cellX) {
+        for (int cellY = firstY; cellY <= lastY; ++cellY) {
+            auto it = cells.find(cellKey(cellX, cellY));
+            if (it == cells.end()) {
+                continue;
+            }
+            for (int id : it->second) {
+                visit(tracked[id]);
+            }
+        }
+    }
+}
+
+void SpatialIndex::queryBodies(const b2Shape& shape, const b2Transform& transform, std::vector<Actor*>& found) {
+    if (!RigidBody::world) {
+        return;
+    }
+
+    b2AABB bounds;
+    shape.ComputeAABB(&bounds, transform, 0);
+
+    for (b2Fixture* fixture : QueryFixtures(bounds)) {
+        Actor* actor = reinterpret_cast<Actor*>(fixture->GetUserData().pointer);
+        if (actor == nullptr) {
+            continue; // Skip fixtures with no associated actor
+        }
+
+        const b2Shape* fixtureShape = fixture->GetShape();
+        const b2Transform& bodyTransform = fixture->GetBody()->GetTransform();
+        for (int child = 0; child < fixtureShape->GetChildCount(); ++child) {
+            if (b2TestOverlap(&shape, 0, fixtureShape, child, transform, bodyTransform)) {
+                found.push_back(actor);
+                break;
+            }
+        }
+    }
+}
+
+luabridge::LuaRef SpatialIndex::toTable(std::vector<Actor*>& found) {
+    // An actor with several fixtures, or a body and a tracked point, is reported once
+    std::sort(found.begin(), found.end(), [](const Actor* a, const Actor* b) { return a->GetID() < b->GetID(); });
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+
+    luabridge::LuaRef actorsTable = luabridge::newTable(LuaHelper::L);
+    for (size_t i = 0; i < found.size(); ++i) {
+        actorsTable[i + 1] = luabridge::LuaRef(LuaHelper::L, found[i]);
+    }
+    return actorsTable;
+}
+
+luabridge::LuaRef SpatialIndex::OverlapCircle(Vector2 center, float radius) {
+    std::vector<Actor*> found;
+
+    b2CircleShape circle;
+    circle.m_radius = radius;
+    b2Transform transform(b2Vec2(center.getX(), center.getY()), b2Rot(0.0f));
+    queryBodies(circle, transform, found);
+
+    float radiusSquared = radius * radius;
+    forEachTrackedIn(center.getX() - radius, center.getY() - radius, center.getX() + radius, center.getY() + radius,
+        [&](const TrackedActor& entry) {
+            float dx = entry.x - center.getX();
+            float dy = entry.y - center.getY();
+            if (dx * dx + dy * dy <= radiusSquared) {
+                found.push_back(entry.actor);
+            }
+        });
+
+    return toTable(found);
+}
+
+luabridge::LuaRef SpatialIndex::OverlapBox(Vector2 center, Vector2 size) {
+    std::vector<Actor*> found;
+    float halfWidth = std::fabs(size.getX()) * 0.5f;
+    float halfHeight = std::fabs(size.getY()) * 0.5f;
+
+    b2PolygonShape box;
+    box.SetAsBox(halfWidth, halfHeight);
+    b2Transform transform(b2Vec2(center.getX(), center.getY()), b2Rot(0.0f));
+    queryBodies(box, transform, found);
+
+    float minX = center.getX() - halfWidth;
+    float minY = center.getY() - halfHeight;
+    float maxX = center.getX() + halfWidth;
+    float maxY = center.getY() + halfHeight;
+    forEachTrackedIn(minX, minY, maxX, maxY, [&](const TrackedActor& entry) {
+        if (entry.x >= minX && entry.x <= maxX && entry.y >= minY && entry.y <= maxY) {
+            found.push_back(entry.actor);
+        }
+    });
+
+    return toTable(found);
+}
+
+luabridge::LuaRef SpatialIndex::Nearest(Vector2 pos, const std::string& actorName) {
+    const std::map<int, Actor*>* candidates = ActorRegistry::FindAllByName(actorName);
+    if (!candidates) {
+        return luabridge::LuaRef(LuaHelper::L);
+    }
+
+    Actor* nearest = nullptr;
+    float nearestDistanceSquared = 0.0f;
+    for (const auto& [id, actor] : *candidates) {
+        float x, y;
+        auto trackedIt = tracked.find(id);
+        if (trackedIt != tracked.end()) {
+            x = trackedIt->second.x;
+            y = trackedIt->second.y;
+        }
+        else {
+            luabridge::LuaRef rigidbody = actor->GetComponent("Rigidbody");
+            if (rigidbody.isNil()) {
+                continue; // No position to measure
+            }
+            Vector2 bodyPosition = rigidbody.cast<RigidBody*>()->GetPosition();
+            x = bodyPosition.getX();
+            y = bodyPosition.getY();
+        }
+
+        float dx = x - pos.getX();
+        float dy = y - pos.getY();
+        float distanceSquared = dx * dx + dy * dy;
+        if (!nearest || distanceSquared < nearestDistanceSquared) {
+            nearest = actor;
+            nearestDistanceSquared = distanceSquared;
+        }
+    }
+
+    if (!nearest) {
+        return luabridge::LuaRef(LuaHelper::L);
+    }
+    return luabridge::LuaRef(LuaHelper::L, nearest);
+}
+
+void SpatialIndex::Track(Actor* actor, Vector2 pos) {
+    if (!actor) {
+        return;
+    }
+
+    uint64_t cell = cellOf(pos.getX(), pos.getY());
+    auto it = tracked.find(actor->GetID());
+    if (it == tracked.end()) {
+        tracked[actor->GetID()] = { actor, pos.getX(), pos.getY(), cell };
+        cells[cell].push_back(actor->GetID());
+        return;
+    }
+
+    TrackedActor& entry = it->second;
+    entry.x = pos.getX();
+    entry.y = pos.getY();
+    if (entry.cell != cell) {
+        removeFromCell(entry.cell, actor->GetID());
+        cells[cell].push_back(actor->GetID());
+        entry.cell = cell;
+    }
+}
+
+void SpatialIndex::Untrack(Actor* actor) {
+    if (actor) {
+        Remove(actor->GetID());
+    }
+}
+
+void SpatialIndex::Remove(int actorId) {
+    auto it = tracked.find(actorId);
+    if (it == tracked.end()) {
+        return;
+    }
+    removeFromCell(it->second.cell, actorId);
+    tracked.erase(it);
+}
+
+void SpatialIndex::Clear() {
+    cells.clear();
+    tracked.clear();
+}
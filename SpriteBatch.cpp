@@ -0,0 +1,81 @@
+#include "headers/SpriteBatch.h"
+#include <cmath>
+
+static const float kDegreesToRadians = 3.14159265358979f / 180.0f;
+
+SDL_Texture* SpriteBatch::currentTexture = nullptr;
+std::vector<SDL_Vertex> SpriteBatch::vertices;
+std::vector<int> SpriteBatch::indices;
+bool SpriteBatch::enabled = true;
+uint64_t SpriteBatch::frameBatches = 0;
+uint64_t SpriteBatch::frameSprites = 0;
+
+void SpriteBatch::Add(SDL_Renderer* renderer, SDL_Texture* texture, const SDL_Rect* srcRect, int textureWidth, int textureHeight,
+    const SDL_Rect& destRect, const SDL_FPoint& center, float rotationDegrees, float scale, SDL_Color color) {
+    if (texture != currentTexture) {
+        Flush(renderer);
+        currentTexture = texture;
+    }
+
+    // Texture coordinates of the source rectangle
+    float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+    if (srcRect) {
+        u0 = static_cast<float>(srcRect->x) / textureWidth;
+        v0 = static_cast<float>(srcRect->y) / textureHeight;
+        u1 = static_cast<float>(srcRect->x + srcRect->w) / textureWidth;
+        v1 = static_cast<float>(srcRect->y + srcRect->h) / textureHeight;
+    }
+
+    // Corners relative to the pivot, rotated clockwise like SDL_RenderCopyEx
+    const float corners[4][2] = {
+        { -center.x, -center.y },
+        { destRect.w - center.x, -center.y },
+        { destRect.w - center.x, destRect.h - center.y },
+        { -center.x, destRect.h - center.y }
+    };
+    const float uvs[4][2] = { { u0, v0 }, { u1, v0 }, { u1, v1 }, { u0, v1 } };
+
+    float cosine = 1.0f, sine = 0.0f;
+    if (rotationDegrees != 0.0f) {
+        float radians = rotationDegrees * kDegreesToRadians;
+        cosine = std::cos(radians);
+        sine = std::sin(radians);
+    }
+
+    float pivotX = destRect.x + center.x;
+    float pivotY = destRect.y + center.y;
+    int base = static_cast<int>(vertices.size());
+
+    for (int i = 0; i < 4; ++i) {
+        SDL_Vertex vertex;
+        vertex.position.x = (pivotX + corners[i][0] * cosine - corners[i][1] * sine) * scale;
+        vertex.position.y = (pivotY + corners[i][0] * sine + corners[i][1] * cosine) * scale;
+        vertex.color = color;
+        vertex.tex_coord.x = uvs[i][0];
+        vertex.tex_coord.y = uvs[i][1];
+        vertices.push_back(vertex);
+    }
+
+    indices.push_back(base);
+    indices.push_back(base + 1);
+    indices.push_back(base + 2);
+    indices.push_back(base);
+    indices.push_back(base + 2);
+    indices.push_back(base + 3);
+
+    frameSprites++;
+}
+
+void SpriteBatch::Flush(SDL_Renderer* renderer) {
+    if (vertices.empty()) {
+        currentTexture = nullptr;
+        return;
+    }
+
+    SDL_RenderGeometry(renderer, currentTexture, vertices.data(), static_cast<int>(vertices.size()), indices.data(), static_cast<int>(indices.size()));
+    frameBatches++;
+
+    vertices.clear();
+    indices.clear();
+    currentTexture = nullptr;
+}
@@ -9,11 +9,49 @@
 #include "headers/MainHelper.h"
 #include "headers/Scene.h"
 #include "headers/RigidBody.h"
+#include "headers/ActorPool.h"
+#include "headers/CookedAsset.h"
 #include <vector>
 
 std::unordered_map<std::string, Actor*> TemplateDB::templates = {};
 extern std::string gamePlaying;
 
+// Cooked counterpart of the JSON path in loadTemplate
+static void loadCookedTemplate(const std::string& templateName, const CookedAsset& cooked) {
+    const Cooked::Header& header = cooked.GetHeader();
+    if (header.actorCount != 1) {
+        std::cout << "error: template " << templateName << " is not a cooked template";
+        std::exit(0);
+    }
+
+    const Cooked::Actor& actor = cooked.Actors()[0];
+    Actor* actorTemplate = new Actor(std::string(actor.name != Cooked::kNone ? cooked.String(actor.name) : ""));
+
+    for (uint32_t c = 0; c < actor.componentCount; ++c) {
+        const Cooked::Component& component = cooked.Components()[actor.firstComponent + c];
+        std::string key = cooked.String(component.key);
+        if (component.type == Cooked::kNone) {
+            std::cout << "error: template " << templateName << " component " << key << " has no type";
+            std::exit(0);
+        }
+
+        std::string componentName = cooked.String(component.type);
+        if (componentName == "Rigidbody") {
+            RigidBody::InitializeWorld();
+        }
+        else {
+            Scene::verifyComponentType(componentName);
+        }
+        actorTemplate->addComponent(key, componentName);
+        cooked.ApplyProperties(component, *actorTemplate->actor_components[key]);
+    }
+
+    TemplateDB::templates[templateName] = actorTemplate;
+    if (header.poolPrewarm >= 0) {
+        ActorPool::Configure(templateName, *actorTemplate, header.poolPrewarm, header.poolMax);
+    }
+}
+
 Actor* TemplateDB::getTemplate(std::string& templateName){
     auto it = templates.find(templateName);
     if (it != templates.end()) {
@@ -26,6 +64,12 @@ void TemplateDB::loadTemplate(std::string& templateName) {
     std::string path = "resources/" + gamePlaying + "/actor_templates/" + templateName + ".template";
     rapidjson::Document d;
 
+    CookedAsset cooked;
+    if (cooked.Open(path)) {
+        loadCookedTemplate(templateName, cooked);
+        return;
+    }
+
       // WINDOWS
      const std::filesystem::path configFile{path};
      if (!std::filesystem::exists(configFile)) {
@@ -86,5 +130,13 @@ void TemplateDB::loadTemplate(std::string& templateName) {
     }
     
     templates[templateName] = actorTemplate;
+
+    // Optional instance pool: "pool": { "prewarm": 32, "max": 256 }
+    if (d.HasMember("pool") && d["pool"].IsObject()) {
+        const auto& pool = d["pool"];
+        int prewarm = pool.HasMember("prewarm") && pool["prewarm"].IsInt() ? pool["prewarm"].GetInt() : 0;
+        int maxSize = pool.HasMember("max") && pool["max"].IsInt() ? pool["max"].GetInt() : 0;
+        ActorPool::Configure(templateName, *actorTemplate, prewarm, maxSize);
+    }
     
 }
\ No newline at end of file
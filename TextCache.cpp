@@ -0,0 +1,74 @@
+#include "headers/TextCache.h"
+
+size_t TextCache::budgetBytes = 16 * 1024 * 1024;
+uint64_t TextCache::hits = 0;
+uint64_t TextCache::misses = 0;
+uint64_t TextCache::evictions = 0;
+std::list<TextCache::Entry> TextCache::lru;
+std::unordered_map<std::string, std::list<TextCache::Entry>::iterator> TextCache::entries;
+size_t TextCache::bytesUsed = 0;
+
+static std::string makeKey(TTF_Font* font, SDL_Color color, const std::string& text) {
+    // The font pointer already identifies the font file and point size
+    std::string key;
+    key.reserve(sizeof(font) + sizeof(color) + text.size());
+    key.append(reinterpret_cast<const char*>(&font), sizeof(font));
+    key.append(reinterpret_cast<const char*>(&color), sizeof(color));
+    key.append(text);
+    return key;
+}
+
+SDL_Texture* TextCache::Get(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, SDL_Color color, int& width, int& height) {
+    std::string key = makeKey(font, color, text);
+
+    auto found = entries.find(key);
+    if (found != entries.end()) {
+        hits++;
+        lru.splice(lru.begin(), lru, found->second);
+        width = found->second->width;
+        height = found->second->height;
+        return found->second->texture;
+    }
+
+    misses++;
+    SDL_Surface* surface = TTF_RenderText_Solid(font, text.c_str(), color);
+    if (!surface) {
+        return nullptr;
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    width = surface->w;
+    height = surface->h;
+    SDL_FreeSurface(surface);
+    if (!texture) {
+        return nullptr;
+    }
+
+    size_t bytes = static_cast<size_t>(width) * height * 4;
+    lru.push_front({ std::move(key), texture, width, height, bytes });
+    entries[lru.front().key] = lru.begin();
+    bytesUsed += bytes;
+
+    evictToBudget();
+    return texture;
+}
+
+void TextCache::evictToBudget() {
+    // Never evict the entry that was just added, even if it alone is over budget
+    while (bytesUsed > budgetBytes && lru.size() > 1) {
+        Entry& oldest = lru.back();
+        SDL_DestroyTexture(oldest.texture);
+        bytesUsed -= oldest.bytes;
+        entries.erase(oldest.key);
+        lru.pop_back();
+        evictions++;
+    }
+}
+
+void TextCache::Clear() {
+    for (auto& entry : lru) {
+        SDL_DestroyTexture(entry.texture);
+    }
+    lru.clear();
+    entries.clear();
+    bytesUsed = 0;
+}
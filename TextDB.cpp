@@ -1,4 +1,9 @@
 #include "headers/TextDB.h"
+#include "headers/Headless.h"
+#include "headers/Profiler.h"
+#include "headers/TextCache.h"
+#include "headers/GlyphAtlas.h"
+#include "headers/SpriteBatch.h"
 
 std::vector<TextStruct> TextDB::textQueue;
 std::unordered_map<std::string, std::unordered_map<int, TTF_Font*>> TextDB::fontCache;
@@ -51,6 +56,8 @@ void TextDB::checkFontExists(const std::string& fontPath) {
 }
 
 void TextDB::Clear() {
+    TextCache::Clear();
+    GlyphAtlas::Clear();
     for (auto& fontBySize : fontCache) {
         for (auto& font : fontBySize.second) {
             TTF_CloseFont(font.second);
@@ -79,16 +86,27 @@ void TextDB::DrawText(const std::string& str_content, float x, float y, const st
 
 
 void TextDB::RenderAllText(SDL_Renderer* renderer) {
+    ProfileScope scope("TextDB::RenderAllText");
+#ifdef ENGINE_HEADLESS
+    // No renderer to rasterize into; just account for the queued strings.
+    Headless::RecordTextCommands(textQueue.size());
+    textQueue.clear();
+#else
     for (auto& ts : textQueue) {
-        SDL_Surface* surface = TTF_RenderText_Solid(ts.font, ts.text.c_str(), ts.color);
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-        ts.position.w = surface->w;
-        ts.position.h = surface->h;
-        SDL_RenderCopy(renderer, texture, NULL, &ts.position);
-        SDL_FreeSurface(surface);
-        SDL_DestroyTexture(texture);
+        if (GlyphAtlas::enabled && GlyphAtlas::Draw(renderer, ts.font, ts.text, ts.color, ts.position.x, ts.position.y)) {
+            continue;
+        }
+
+        // Glyph quads queued so far must land underneath this string
+        SpriteBatch::Flush(renderer);
+        SDL_Texture* texture = TextCache::Get(renderer, ts.font, ts.text, ts.color, ts.position.w, ts.position.h);
+        if (texture) {
+            SDL_RenderCopy(renderer, texture, NULL, &ts.position);
+        }
     }
+    SpriteBatch::Flush(renderer);
     textQueue.clear();
+#endif
 }
 
 
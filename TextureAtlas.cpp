@@ -0,0 +1,138 @@
+#include "headers/TextureAtlas.h"
+#include "headers/ImageDecoder.h"
+#include "headers/TextureBudget.h"
+#include <algorithm>
+#include <filesystem>
+
+extern std::string gamePlaying;
+
+bool TextureAtlas::enabled = true;
+std::vector<SDL_Texture*> TextureAtlas::pages;
+std::unordered_map<std::string, AtlasRegion> TextureAtlas::regions;
+
+const AtlasRegion* TextureAtlas::Find(const std::string& imageName) {
+    auto it = regions.find(imageName);
+    if (it == regions.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void TextureAtlas::Clear() {
+    for (SDL_Texture* page : pages) {
+        SDL_DestroyTexture(page);
+    }
+    pages.clear();
+    regions.clear();
+    TextureBudget::SetPinnedBytes(0);
+}
+
+void TextureAtlas::Build(SDL_Renderer* renderer) {
+    Clear();
+
+    const std::filesystem::path imageDirectory{ "resources/" + gamePlaying + "/images" };
+    if (!enabled || !std::filesystem::exists(imageDirectory)) {
+        return;
+    }
+
+    int pageSize = 2048;
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) == 0 && info.max_texture_width > 0 && info.max_texture_height > 0) {
+        pageSize = std::min({ pageSize, info.max_texture_width, info.max_texture_height });
+    }
+
+    struct PendingImage {
+        std::string name;
+        SDL_Surface* surface;
+    };
+    std::vector<PendingImage> images;
+
+    std::vector<std::string> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(imageDirectory)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".png") {
+            paths.push_back(entry.path().string());
+        }
+    }
+
+    // Decoded and converted to RGBA32 across the cores
+    ImageDecoder::DecodeAll(paths, [&](size_t index, SDL_Surface* converted) {
+        if (!converted) {
+            return; // ImageDB reports it if it is ever drawn
+        }
+
+        // Too big to share a page; leave it to ImageDB
+        if (converted->w + 2 * kPadding > pageSize || converted->h + 2 * kPadding > pageSize) {
+            SDL_FreeSurface(converted);
+            return;
+        }
+        images.push_back({ std::filesystem::path{ paths[index] }.stem().string(), converted });
+        }, true);
+
+    // Tallest first keeps the shelves tight
+    std::sort(images.begin(), images.end(), [](const PendingImage& a, const PendingImage& b) {
+        if (a.surface->h != b.surface->h) return a.surface->h > b.surface->h;
+        if (a.surface->w != b.surface->w) return a.surface->w > b.surface->w;
+        return a.name < b.name;
+        });
+
+    SDL_Surface* page = nullptr;
+    int cursorX = 0, cursorY = 0, shelfHeight = 0;
+    std::vector<std::pair<std::string, SDL_Rect>> placed;
+    size_t pageBytes = 0;
+
+    auto finishPage = [&]() {
+        // Only upload the rows that were used
+        int usedHeight = cursorY + shelfHeight;
+        SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, pageSize, usedHeight);
+        if (texture) {
+            SDL_UpdateTexture(texture, NULL, page->pixels, page->pitch);
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+            pages.push_back(texture);
+            pageBytes += static_cast<size_t>(pageSize) * usedHeight * 4;
+            for (const auto& [name, rect] : placed) {
+                regions[name] = { texture, rect, pageSize, usedHeight };
+            }
+        }
+        SDL_FreeSurface(page);
+        page = nullptr;
+        placed.clear();
+    };
+
+    for (auto& image : images) {
+        int paddedWidth = image.surface->w + 2 * kPadding;
+        int paddedHeight = image.surface->h + 2 * kPadding;
+
+        if (page && cursorX + paddedWidth > pageSize) {
+            cursorX = 0;
+            cursorY += shelfHeight;
+            shelfHeight = 0;
+        }
+        if (page && cursorY + paddedHeight > pageSize) {
+            finishPage();
+        }
+        if (!page) {
+            page = SDL_CreateRGBSurfaceWithFormat(0, pageSize, pageSize, 32, SDL_PIXELFORMAT_RGBA32);
+            if (!page) {
+                break;
+            }
+            SDL_FillRect(page, NULL, 0);
+            cursorX = cursorY = shelfHeight = 0;
+        }
+
+        SDL_Rect destRect = { cursorX + kPadding, cursorY + kPadding, image.surface->w, image.surface->h };
+        SDL_SetSurfaceBlendMode(image.surface, SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(image.surface, NULL, page, &destRect);
+        placed.push_back({ image.name, destRect });
+
+        cursorX += paddedWidth;
+        shelfHeight = std::max(shelfHeight, paddedHeight);
+    }
+    if (page) {
+        finishPage();
+    }
+
+    for (auto& image : images) {
+        SDL_FreeSurface(image.surface);
+    }
+    TextureBudget::SetPinnedBytes(pageBytes);
+}
@@ -0,0 +1,156 @@
+#include "headers/TextureBudget.h"
+#include "headers/ImageRegistry.h"
+#include <algorithm>
+
+size_t TextureBudget::budgetBytes = 256 * 1024 * 1024;
+uint64_t TextureBudget::idleFrames = 600;
+uint64_t TextureBudget::evictions = 0;
+uint64_t TextureBudget::reloads = 0;
+std::unordered_map<std::string, SDL_Texture*>* TextureBudget::cache = nullptr;
+std::vector<TextureBudget::Entry> TextureBudget::entries;
+std::unordered_map<std::string, int> TextureBudget::sceneIds;
+int TextureBudget::currentScene = -1; // the initial scene, until the first scene switch
+uint64_t TextureBudget::frame = 0;
+uint64_t TextureBudget::generation = 0;
+size_t TextureBudget::bytesUsed = 0;
+size_t TextureBudget::pinnedBytes = 0;
+size_t TextureBudget::resident = 0;
+
+void TextureBudget::Attach(std::unordered_map<std::string, SDL_Texture*>* imageCache) {
+    cache = imageCache;
+}
+
+void TextureBudget::Track(const std::string& imageName, SDL_Texture* texture) {
+    int imageId = ImageRegistry::Resolve(imageName);
+    if (imageId >= static_cast<int>(entries.size())) {
+        entries.resize(imageId + 1);
+    }
+    Entry& entry = entries[imageId];
+    if (entry.texture) {
+        return;
+    }
+    if (entry.loadedBefore) {
+        reloads++;
+    }
+
+    Uint32 format = 0;
+    int width = 0, height = 0;
+    SDL_QueryTexture(texture, &format, NULL, &width, &height);
+    entry.texture = texture;
+    entry.bytes = static_cast<size_t>(width) * height * std::max(1, static_cast<int>(SDL_BYTESPERPIXEL(format)));
+    entry.lastUsedFrame = frame;
+    entry.loadedBefore = true;
+    reference(entry);
+    bytesUsed += entry.bytes;
+    resident++;
+}
+
+void TextureBudget::Touch(int imageId) {
+    if (imageId < 0 || imageId >= static_cast<int>(entries.size())) {
+        return;
+    }
+    Entry& entry = entries[imageId];
+    entry.lastUsedFrame = frame;
+    if (entry.lastScene != currentScene) {
+        reference(entry);
+    }
+}
+
+void TextureBudget::Touch(const std::string& imageName) {
+    Touch(ImageRegistry::Resolve(imageName));
+}
+
+void TextureBudget::reference(Entry& entry) {
+    entry.lastScene = currentScene;
+    if (std::find(entry.scenes.begin(), entry.scenes.end(), currentScene) == entry.scenes.end()) {
+        entry.scenes.push_back(currentScene);
+    }
+}
+
+void TextureBudget::BeginScene(const std::string& sceneName) {
+    auto inserted = sceneIds.emplace(sceneName, static_cast<int>(sceneIds.size()));
+    int sceneId = inserted.first->second;
+    if (sceneId == currentScene) {
+        return; // reloading the same scene keeps its textures referenced
+    }
+
+    for (Entry& entry : entries) {
+        entry.scenes.erase(std::remove(entry.scenes.begin(), entry.scenes.end(), currentScene), entry.scenes.end());
+        if (entry.lastScene == currentScene) {
+            entry.lastScene = -2;
+        }
+    }
+    currentScene = sceneId;
+}
+
+void TextureBudget::EndFrame() {
+    frame++;
+    if (frame % kSweepInterval == 0) {
+        sweepUnreferenced();
+    }
+    if (budgetBytes > 0 && BytesUsed() > budgetBytes) {
+        evictToBudget();
+    }
+}
+
+void TextureBudget::sweepUnreferenced() {
+    for (size_t imageId = 0; imageId < entries.size(); ++imageId) {
+        const Entry& entry = entries[imageId];
+        if (entry.texture && entry.scenes.empty() && frame - entry.lastUsedFrame >= idleFrames) {
+            evict(static_cast<int>(imageId));
+        }
+    }
+}
+
+void TextureBudget::evictToBudget() {
+    std::vector<int> candidates;
+    for (size_t imageId = 0; imageId < entries.size(); ++imageId) {
+        const Entry& entry = entries[imageId];
+        if (entry.texture && frame - entry.lastUsedFrame >= idleFrames) {
+            candidates.push_back(static_cast<int>(imageId));
+        }
+    }
+
+    // Unreferenced first, then least recently drawn
+    std::sort(candidates.begin(), candidates.end(), [](int a, int b) {
+        const Entry& first = entries[a];
+        const Entry& second = entries[b];
+        if (first.scenes.empty() != second.scenes.empty()) return first.scenes.empty();
+        return first.lastUsedFrame < second.lastUsedFrame;
+        });
+
+    // Textures drawn within idleFrames stay, even if they alone are over budget
+    for (int imageId : candidates) {
+        if (BytesUsed() <= budgetBytes) {
+            break;
+        }
+        evict(imageId);
+    }
+}
+
+void TextureBudget::evict(int imageId) {
+    Entry& entry = entries[imageId];
+    SDL_DestroyTexture(entry.texture);
+    if (cache) {
+        if (const std::string* imageName = ImageRegistry::NameOf(imageId)) {
+            cache->erase(*imageName);
+        }
+    }
+    bytesUsed -= entry.bytes;
+    resident--;
+    entry.texture = nullptr;
+    entry.bytes = 0;
+    entry.scenes.clear();
+    entry.lastScene = -2;
+    evictions++;
+    generation++;
+}
+
+void TextureBudget::Clear() {
+    entries.clear();
+    sceneIds.clear();
+    currentScene = -1;
+    bytesUsed = 0;
+    resident = 0;
+    generation++;
+}
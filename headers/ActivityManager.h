@@ -0,0 +1,46 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "Actor.h"
+#include "RigidBody.h"
+
+// Dormant actors: an actor whose Rigidbody has can_go_dormant set (default from
+// "dormant_actors" in game.config) goes dormant while Box2D has its body asleep
+// and the body is off-screen by more than "dormant_margin" world units. Its
+// components then skip OnUpdate and OnLateUpdate. It wakes as soon as either
+// condition ends: a contact or force wakes the body, the camera comes close, or a
+// script (e.g. an event handler) calls Rigidbody:SetAwake(true).
+// Also holds the Lua accessors for Box2D's per-body sleep state.
+class ActivityManager {
+public:
+    // Recomputes the dormant set; called once per frame before the update passes.
+    // The view extents are in world units around the camera position.
+    static void Update(float viewHalfWidth, float viewHalfHeight);
+
+    static void Register(Actor* actor, RigidBody* body);
+    static void Unregister(int actorId);
+    static void Clear();
+
+    // Sorted ids of the dormant actors, for ComponentDispatch to skip
+    static const std::vector<int>& DormantIds() { return dormantIds; }
+
+    static void CopySettings(const RigidBody* from, const RigidBody* to);
+
+    // Lua
+    static bool IsAwake(const RigidBody* body);
+    static void SetAwake(RigidBody* body, bool awake);
+    static bool IsSleepingAllowed(const RigidBody* body);
+    static void SetSleepingAllowed(RigidBody* body, bool allowed);
+    static bool GetCanGoDormant(const RigidBody* body);
+    static void SetCanGoDormant(RigidBody* body, bool allowed);
+    static bool IsDormant(const Actor* actor);
+
+    static bool dormantByDefault;
+    static float margin;
+
+private:
+    static std::unordered_map<int, RigidBody*> candidates; // by actor id
+    static std::unordered_map<const RigidBody*, bool> canGoDormant;
+    static std::vector<int> dormantIds;
+};
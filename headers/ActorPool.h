@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Actor.h"
+
+// Per-template actor pools for Actor.Instantiate / Actor.Destroy. A template opts
+// in from its file:
+//   "pool": { "prewarm": 32, "max": 256 }
+// prewarm instances are built when the template loads; max caps how many
+// destroyed instances are kept (0 = no cap). Destroy hands an instance back to
+// its pool instead of freeing it: component tables are emptied so they fall back
+// to the template's values again, Rigidbodies are reset from the template and
+// get a new b2Body from OnStart. Instantiate then reuses it under a new id.
+// Instances that had components added or removed at runtime are not pooled.
+// Lua references to a destroyed actor may see it come back as a new instance.
+class ActorPool {
+public:
+    // Reads the "pool" block of a template file and builds the prewarmed instances
+    static void Configure(const std::string& templateName, const Actor& actorTemplate, int prewarm, int maxSize);
+
+    // A reset instance for templateName, or nullptr if the template is not pooled
+    // or its pool is empty. The caller gives it a fresh id.
+    static std::shared_ptr<Actor> Acquire(const std::string& templateName);
+
+    // Records that a live actor came from a pooled template
+    static void Track(int actorId, const std::string& templateName);
+
+    // Called once a destroyed actor is out of the registry. Returns false if the
+    // actor was not pooled and should just be dropped.
+    static bool Release(const std::shared_ptr<Actor>& actor);
+
+    // Live instances were dropped by a scene change without being destroyed
+    static void ForgetInstances();
+    static void Clear();
+
+    // Lua: { available, in_use, created, reused } or nil for unpooled templates
+    static luabridge::LuaRef GetStats(const std::string& templateName, lua_State* L);
+    static size_t AvailableCount();
+
+private:
+    struct Pool {
+        const Actor* actorTemplate = nullptr;
+        std::vector<std::shared_ptr<Actor>> available;
+        size_t maxSize = 0;
+        size_t inUse = 0;
+        size_t created = 0;
+        size_t reused = 0;
+    };
+
+    static bool matchesTemplate(const Actor& actor, const Actor& actorTemplate);
+    static void reset(Actor& actor, const Actor& actorTemplate);
+
+    static std::unordered_map<std::string, Pool> pools;
+    static std::unordered_map<int, std::string> instances; // live actor id -> template
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Actor.h"
+
+// Generational handle to a live actor. A handle goes stale as soon as its actor
+// is removed; the slot it points at may be reused, but with a new generation.
+struct ActorHandle {
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool IsNull() const { return slot == UINT32_MAX; }
+};
+
+// Slot map over the live actors. hardcoded_actors is the dense array: it stays
+// contiguous and removal swaps the last actor into the hole, so iteration order
+// is not creation order (lifecycle order is kept by ComponentDispatch).
+// Actors are also indexed by id and by name; name lookups return the lowest id
+// first, matching the order the old linear scans found them in. Actors waiting in
+// deferredActorAdditions get their own name index so Find/FindAll never scan.
+class ActorRegistry {
+public:
+    static ActorHandle Add(const std::shared_ptr<Actor>& actor);
+    static bool Remove(int actorId);
+    static void Clear();
+
+    static Actor* Get(ActorHandle handle);
+    static std::shared_ptr<Actor> GetShared(int actorId);
+    static ActorHandle HandleOf(int actorId);
+
+    static Actor* FindFirstByName(const std::string& name);
+    static const std::map<int, Actor*>* FindAllByName(const std::string& name);
+
+    // Name index for actors created by Instantiate that are not live yet.
+    // Add() moves them over to the live index.
+    static void AddPending(Actor* actor);
+    static Actor* FindFirstPendingByName(const std::string& name);
+    static const std::map<int, Actor*>* FindAllPendingByName(const std::string& name);
+    static void ClearPending();
+
+    // Bumped whenever the set of actors (live or pending) carrying name changes.
+    // An actor going from pending to live is not a membership change.
+    static uint64_t NameVersion(const std::string& name);
+
+    // Renames an actor and keeps the name index in sync. Safe to call on actors
+    // that are not registered (e.g. still waiting in deferredActorAdditions).
+    static void Rename(Actor* actor, const std::string& newName);
+
+    static size_t Count();
+
+private:
+    struct Slot {
+        uint32_t denseIndex;
+        uint32_t generation;
+    };
+
+    static bool removeFromNameIndex(std::unordered_map<std::string, std::map<int, Actor*>>& index, const std::string& name, int actorId);
+    static void bumpAllNameVersions();
+
+    static std::vector<Slot> slots;
+    static std::vector<uint32_t> freeSlots;
+    static std::vector<uint32_t> denseSlots; // parallel to hardcoded_actors
+    static std::unordered_map<int, uint32_t> slotById;
+    static std::unordered_map<std::string, std::map<int, Actor*>> byName;
+    static std::unordered_map<std::string, std::map<int, Actor*>> pendingByName;
+    static std::unordered_map<std::string, uint64_t> nameVersions;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "CookedAsset.h"
+#include "MainHelper.h"
+
+struct SDL_Surface;
+struct SDL_Renderer;
+struct Mix_Chunk;
+
+// Images, sound effects and fonts one scene refers to
+struct AssetList {
+    std::string gameFolder;
+    std::vector<std::string> images;
+    std::vector<std::string> sounds;
+    std::vector<std::pair<std::string, int>> fonts; // name, point size
+};
+
+// Decoded off the main thread, waiting to be uploaded by it
+struct DecodedAssets {
+    std::unordered_map<std::string, SDL_Surface*> images;
+    std::unordered_map<std::string, Mix_Chunk*> sounds;
+    std::vector<std::pair<std::string, int>> fonts; // SDL_ttf is not thread-safe; opened on upload
+    double decodeMs = 0.0;
+};
+
+// Warms the image, sound and font caches before a scene's first frame, so the
+// first draw of a sprite or play of a sound no longer stalls on decoding.
+// The asset list comes from resources/<game>/scenes/<scene>.preload if present:
+//   { "images": ["player"], "sounds": ["jump"], "fonts": [{ "name": "NotoSans", "size": 16 }] }
+// otherwise from scanning the string fields of the scene's and its templates'
+// components for names that exist under images/, audio/ or fonts/ (a font is
+// preloaded at each int field of the same component whose name ends in "size").
+// The synchronous loads scan the actors sparseSceneFile just built; SceneLoader
+// scans the cooked scene and templates it already read on its thread.
+// Images are decoded to surfaces on ImageDecoder's workers and uploaded on the
+// main thread as they arrive; atlas-covered images are skipped. Sounds wait in a side table until
+// AudioDB asks for them. Set "preload_assets": false in game.config to turn it off.
+class AssetPreloader {
+public:
+    // Blocking: collect, decode in parallel, upload. Used by the synchronous loads,
+    // after sparseSceneFile added the scene's actors to hardcoded_actors from firstActor on.
+    static void PreloadScene(const std::string& scenePath, SDL_Renderer* renderer, size_t firstActor = 0);
+
+    // The building blocks, also used by SceneLoader's background thread
+    static AssetList Collect(const CookedAsset& scene, const std::string& scenePath, const std::string& gameFolder);
+    static void Decode(const AssetList& list, DecodedAssets& out, const std::atomic<bool>* cancel = nullptr, std::atomic<uint32_t>* done = nullptr);
+    static void Upload(DecodedAssets& assets, SDL_Renderer* renderer);
+    static void Discard(DecodedAssets& assets);
+
+    // For ImageDB / AudioDB: a preloaded asset, whose ownership passes to the caller
+    static SDL_Surface* TakeImage(const std::string& imageName);
+    static Mix_Chunk* TakeSound(const std::string& soundName);
+
+    static void Clear();
+
+    // Lua: Application.GetPreloadStats()
+    static luabridge::LuaRef GetStats(lua_State* L);
+
+    static bool enabled;
+
+    // Last preload
+    static double lastDecodeMs;
+    static double lastUploadMs;
+    static size_t lastImages;
+    static size_t lastSounds;
+    static size_t lastFonts;
+    static size_t totalPreloads;
+
+private:
+    static AssetList collectLoaded(const std::string& scenePath, size_t firstActor, const std::string& gameFolder);
+    static bool readManifest(const std::string& manifestPath, AssetList& list);
+    static void decodeSounds(const AssetList& list, DecodedAssets& out, const std::atomic<bool>* cancel, std::atomic<uint32_t>* done);
+    static void uploadImage(const std::string& imageName, SDL_Surface* surface, SDL_Renderer* renderer);
+
+    static std::unordered_map<std::string, SDL_Surface*> images;
+    static std::unordered_map<std::string, Mix_Chunk*> sounds;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+#include "ComponentDispatch.h"
+
+// One contact callback for one actor. Both actors of a contact get their own event.
+struct CollisionEvent {
+    CollisionPhase phase;
+    Actor* actor;
+    int actorId;
+    Actor* other;
+    int otherId;
+    b2Vec2 point;
+    b2Vec2 normal;
+    b2Vec2 relativeVelocity;
+};
+
+// Contacts reported by ColliderDetector during b2World::Step are only recorded
+// here; Dispatch runs the Lua handlers afterwards, in the order Box2D reported the
+// contacts. Box2D also ends contacts when a body is destroyed, outside Step; those
+// are delivered with the next dispatch. An actor that is gone by then gets no
+// event, and an event whose other actor is gone reports other as nil.
+class CollisionEvents {
+public:
+    static void Record(CollisionPhase phase, Actor* actorA, Actor* actorB, const b2Vec2& point, const b2Vec2& normal, const b2Vec2& relativeVelocity);
+    static void Dispatch();
+    static void Clear();
+
+    static size_t PendingCount() { return events.size(); }
+
+private:
+    static std::vector<CollisionEvent> events;
+    static std::vector<CollisionEvent> dispatchingEvents;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "RigidBody.h"
+
+// Box2D collision filtering for Rigidbody components. Each Rigidbody has a layer,
+// the layers it collides with and a group index; they are set like any other
+// Rigidbody property from scene/template JSON or Lua:
+//   "layer": "Bullet", "collides_with": "Enemy,Wall", "collision_group": -1
+// collides_with is a comma-separated list of layer names, "all" (the default) or
+// "none". Layer names come from "collision_layers": ["Player", "Enemy", ...] in
+// game.config; "Default" is always layer 0 and the list fills layers 1-15.
+// A negative shared group never collides within itself, a positive one always does.
+// Names are resolved when the body is created, so properties can be set before
+// game.config has been read.
+class CollisionFilters {
+public:
+    static b2Filter FilterFor(const RigidBody* body);
+
+    // Template instances copy their Rigidbody; this carries the filter settings over
+    // (and drops any the copy had, for pooled instances)
+    static void CopySettings(const RigidBody* from, const RigidBody* to);
+
+    // Lua properties
+    static std::string GetLayer(const RigidBody* body);
+    static void SetLayer(RigidBody* body, std::string layer);
+    static std::string GetCollidesWith(const RigidBody* body);
+    static void SetCollidesWith(RigidBody* body, std::string layers);
+    static int GetGroup(const RigidBody* body);
+    static void SetGroup(RigidBody* body, int group);
+
+private:
+    struct Settings {
+        std::string layer = "Default";
+        std::string collidesWith = "all";
+        int group = 0;
+    };
+
+    static void loadLayers();
+    static uint16 layerBit(const std::string& name);
+    static uint16 maskFor(const std::string& layers);
+
+    // Updates the fixtures of a body that already exists
+    static void refresh(RigidBody* body);
+
+    static std::unordered_map<const RigidBody*, Settings> settings;
+    static std::vector<std::string> layerNames;
+    static std::string layersForGame;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "Actor.h"
+#include "MyContactListener.h"
+
+// Contact callbacks, in the order they were registered in ComponentDispatch
+enum class CollisionPhase {
+    CollisionEnter,
+    CollisionExit,
+    TriggerEnter,
+    TriggerExit,
+    Count
+};
+
+// One component that implements a lifecycle function. The function reference is
+// resolved once at registration, so the per-frame passes never walk the
+// component's __index chain looking for functions it does not have.
+struct LifecycleEntry {
+    Actor* actor;
+    int actorId;
+    std::string key;
+    std::string type;
+    std::shared_ptr<luabridge::LuaRef> component;
+    luabridge::LuaRef function;
+    bool removed;
+};
+
+// Per-phase dispatch lists for the Lua lifecycle. Components are registered when
+// they join a live actor and only appear in the lists for the phases they
+// implement. Each list is kept sorted by (actor id, component key), which is the
+// order the passes used to walk hardcoded_actors / actor_components in.
+// Scripts may still assign or replace a function later (self.OnUpdate = ..., or
+// a contact callback set in OnStart): a registered component's table gets a
+// __newindex hook that keeps those functions in a table of their own, between
+// the instance and what it inherits from, and updates the lists on every such
+// assignment.
+// CollisionResponder components also get one list per contact callback, so an
+// actor's handlers are a binary search away when CollisionEvents dispatches.
+class ComponentDispatch {
+public:
+    static void RegisterActor(Actor* actor);
+    static void RegisterComponent(Actor* actor, const std::string& key, const std::shared_ptr<luabridge::LuaRef>& component);
+    static void UnregisterComponent(Actor* actor, const std::string& key);
+    static void UnregisterActor(Actor* actor);
+    static void Clear();
+
+    // ActorPool, when it resets a component: drops the functions scripts assigned to it
+    static void ForgetAssignedFunctions(const luabridge::LuaRef& component);
+
+    static void RunOnStart();
+    static void RunOnUpdate();
+    static void RunOnLateUpdate();
+
+    // Calls phase's function on every CollisionResponder component of actor
+    static void RunCollisionHandlers(CollisionPhase phase, Actor* actor, const Collision& collision);
+    static void BeginCollisionDispatch();
+    static void EndCollisionDispatch();
+
+    static size_t PendingStartCount() { return pendingStart.size(); }
+    static size_t UpdateCount() { return onUpdate.size(); }
+    static size_t LateUpdateCount() { return onLateUpdate.size(); }
+
+private:
+    static void insertEntry(std::vector<LifecycleEntry>& list, LifecycleEntry entry);
+    static void markRemoved(std::vector<LifecycleEntry>& list, int actorId, const std::string* key);
+    static void compact(std::vector<LifecycleEntry>& list);
+    static void flushDeferredRegistrations();
+
+    static void watchAssignments(int actorId, const std::string& key, const luabridge::LuaRef& component);
+    static int onComponentWrite(lua_State* L);
+    static void functionAssigned(int actorId, const std::string& key, const std::string& name, const luabridge::LuaRef& function);
+    static std::vector<LifecycleEntry>* listFor(const std::string& name, const std::string& type);
+
+    static std::vector<LifecycleEntry> pendingStart;
+    static std::vector<LifecycleEntry> onUpdate;
+    static std::vector<LifecycleEntry> onLateUpdate;
+    static std::vector<LifecycleEntry> collisionHandlers[static_cast<int>(CollisionPhase::Count)];
+
+    // Registrations that arrive while a pass is iterating (AddComponent from Lua).
+    static std::vector<std::tuple<Actor*, std::string, std::shared_ptr<luabridge::LuaRef>>> deferredRegistrations;
+    static bool dispatching;
+    static bool hasRemovals;
+};
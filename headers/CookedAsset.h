@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Precompiled ("cooked") .scene and .template files. `make cook` runs the
+// scene_cook tool over resources/, which writes <file>.cooked next to every scene
+// and template. Scene and TemplateDB load the cooked file instead of the JSON
+// whenever it is at least as new as the source.
+//
+// A cooked file is memory-mapped and read in place; it holds one actor for a
+// template, or every actor of a scene:
+//   Header | string offsets | string bytes | actors | components | properties
+// Names, keys, component types and string values are indices into the string
+// table, so each distinct component type appears once and is verified once per
+// load. Properties keep the JSON value type (string/int/float/bool) and are
+// applied in file order, exactly as the JSON loaders do.
+namespace Cooked {
+    constexpr uint32_t kMagic = 0x444B4F43; // "COKD"
+    constexpr uint32_t kVersion = 1;
+    constexpr uint32_t kNone = UINT32_MAX;
+
+    enum class PropertyKind : uint32_t { String, Int, Float, Bool };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t stringCount;
+        uint32_t stringBytes;
+        uint32_t actorCount;
+        uint32_t componentCount;
+        uint32_t propertyCount;
+        int32_t poolPrewarm; // templates only; -1 when there is no "pool" block
+        int32_t poolMax;
+    };
+
+    struct Actor {
+        uint32_t name;     // kNone: keep the template's name
+        uint32_t templateName;
+        uint32_t firstComponent;
+        uint32_t componentCount;
+    };
+
+    struct Component {
+        uint32_t key;
+        uint32_t type;     // kNone: the component comes from the template
+        uint32_t firstProperty;
+        uint32_t propertyCount;
+    };
+
+    struct Property {
+        uint32_t name;
+        PropertyKind kind;
+        union {
+            uint32_t string;
+            int32_t intValue;
+            float floatValue;
+            uint32_t boolValue;
+        };
+    };
+}
+
+class CookedAsset {
+public:
+    CookedAsset() = default;
+    ~CookedAsset();
+    CookedAsset(const CookedAsset&) = delete;
+    CookedAsset& operator=(const CookedAsset&) = delete;
+
+    // Maps sourcePath's cooked file if it exists and is not older than the
+    // source (a missing source is fine). Returns false to fall back to JSON.
+    bool Open(const std::string& sourcePath);
+
+    // Open, or else compile the JSON source in memory. Safe to call off the main
+    // thread (used by the background scene loader).
+    bool Load(const std::string& sourcePath);
+
+    // Compiles a .scene/.template JSON file into its cooked file; prints and
+    // returns false on a parse error
+    static bool Cook(const std::string& sourcePath);
+    static std::string CookedPath(const std::string& sourcePath);
+
+    const Cooked::Header& GetHeader() const { return *header; }
+    const char* String(uint32_t index) const { return strings + stringOffsets[index]; }
+    const Cooked::Actor* Actors() const { return actors; }
+    const Cooked::Component* Components() const { return components; }
+    const Cooked::Property* Properties() const { return properties; }
+
+    // ref[name] = value for every property of component, in file order
+    template <typename Target>
+    void ApplyProperties(const Cooked::Component& component, Target& ref) const {
+        for (uint32_t i = 0; i < component.propertyCount; ++i) {
+            const Cooked::Property& property = properties[component.firstProperty + i];
+            const char* name = String(property.name);
+            switch (property.kind) {
+            case Cooked::PropertyKind::String: ref[name] = std::string(String(property.string)); break;
+            case Cooked::PropertyKind::Int: ref[name] = static_cast<int>(property.intValue); break;
+            case Cooked::PropertyKind::Float: ref[name] = property.floatValue; break;
+            case Cooked::PropertyKind::Bool: ref[name] = property.boolValue != 0; break;
+            }
+        }
+    }
+
+private:
+    static bool compile(const std::string& sourcePath, std::vector<unsigned char>& image);
+    bool validate();
+    void unmap();
+
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    std::vector<unsigned char> owned; // compiled in memory instead of mapped
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    const Cooked::Header* header = nullptr;
+    const uint32_t* stringOffsets = nullptr;
+    const char* strings = nullptr;
+    const Cooked::Actor* actors = nullptr;
+    const Cooked::Component* components = nullptr;
+    const Cooked::Property* properties = nullptr;
+};
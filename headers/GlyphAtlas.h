@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SDL.h"
+#include "SDL_ttf.h"
+
+// Glyph-atlas text mode, for strings that change every frame. The printable ASCII
+// glyphs of each font (file + size) are rasterized once, white, into one texture;
+// strings are then laid out glyph by glyph with kerning and drawn through
+// SpriteBatch, with the text colour in the vertices. Drawing a new string costs no
+// surface allocation or texture upload.
+// Enabled with "text_renderer": "glyph_atlas" in rendering.config.
+class GlyphAtlas {
+public:
+    // Queues text at (x, y) into the sprite batch. Returns false if the string has
+    // characters outside the atlas, in which case the caller should fall back.
+    static bool Draw(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, SDL_Color color, int x, int y);
+
+    // Must be called before the fonts or the renderer the atlases belong to go away.
+    static void Clear();
+
+    static bool enabled;
+
+private:
+    static const int kFirstGlyph = 32;
+    static const int kLastGlyph = 126;
+    static const int kAtlasWidth = 512;
+
+    struct Glyph {
+        SDL_Rect rect;
+        int advance;
+    };
+
+    struct FontAtlas {
+        SDL_Texture* texture;
+        int width;
+        int height;
+        std::vector<Glyph> glyphs;
+    };
+
+    static FontAtlas* atlasFor(SDL_Renderer* renderer, TTF_Font* font);
+
+    static std::unordered_map<TTF_Font*, FontAtlas> atlases;
+};
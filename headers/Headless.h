@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Support for the game_engine_headless build (compiled with ENGINE_HEADLESS).
+// No window, renderer or ImGui context exists in that build: image and text draw
+// calls are recorded here as counts and then discarded, and the main loop runs a
+// fixed number of frames as fast as the CPU allows. The command-line helpers
+// also serve the windowed build's --game / --frames benchmark runs.
+class Headless {
+public:
+    // Reads "--frames N" from the command line, falling back to defaultFrames.
+    static int ParseFrameCount(int argc, char* argv[], int defaultFrames);
+    // Returns the value following option (e.g. "--trace out.json"), or "" if absent.
+    static std::string ParseOption(int argc, char* argv[], const std::string& option);
+
+    static void RecordImageCommands(size_t count);
+    static void RecordTextCommands(size_t count);
+
+    static void PrintSummary(int frames, double seconds);
+
+    static uint64_t imageCommands;
+    static uint64_t textCommands;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct SDL_Surface;
+
+// The CPU half of image loading. IMG_Load (and, if asked, the conversion to
+// RGBA32) runs on a pool of worker threads; each decoded surface comes back
+// through a bounded queue to the thread that asked for it, which does the
+// texture upload while the workers keep decoding. A batch never has more than
+// its queue size of images decoding or waiting, so memory stays bounded when
+// the upload is slower than the decode.
+// "image_decode_threads" (0 = one per core) and "image_decode_queue" in game.config.
+class ImageDecoder {
+public:
+    // Runs on the calling thread for each path, in completion order. Takes
+    // ownership of the surface, which is null if the file could not be decoded.
+    using Consumer = std::function<void(size_t index, SDL_Surface* surface)>;
+
+    // Blocks until every path was decoded and consumed. Safe to call from several
+    // threads at once, and from inside a consumer.
+    static void DecodeAll(const std::vector<std::string>& paths, const Consumer& consume, bool convertToRGBA32 = false, const std::atomic<bool>* cancel = nullptr);
+
+    // Number of workers used from the next DecodeAll on; joins the current ones
+    static void Resize(unsigned int threads);
+
+    // Joins the workers; they start again on the next DecodeAll
+    static void Shutdown();
+
+    static unsigned int WorkerCount();
+
+    static size_t queueCapacity;
+
+private:
+    struct Batch;
+    struct Job {
+        Batch* batch;
+        size_t index;
+    };
+
+    static void start();
+    static void workerLoop();
+    static SDL_Surface* decode(const std::string& path, bool convertToRGBA32);
+
+    static unsigned int threadCount;
+    static std::mutex mutex;
+    static std::condition_variable jobReady;
+    static std::deque<Job> jobs;
+    static std::vector<std::thread> workers;
+    static bool stopping;
+};
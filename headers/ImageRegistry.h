@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Image names resolved to small integer ids. A name is checked on disk once, the
+// first time it is drawn or loaded; every later draw is a hash lookup, and draws
+// through an id from Image.Load skip even that.
+class ImageRegistry {
+public:
+    // Returns the id for imageName, validating it on first use. Exits with
+    // "error: missing image" like the old per-draw check did.
+    static int Resolve(const std::string& imageName);
+    static const std::string* NameOf(int imageId);
+    static void Clear();
+
+    // Lua: Image.Load(name) and the id-taking Draw variants
+    static int Load(std::string imageName);
+    static void DrawById(int imageId, float x, float y);
+    static void DrawExById(int imageId, float x, float y, float rotation_degrees, float scale_x, float scale_y, float pivot_x, float pivot_y, float r, float g, float b, float a, int sorting_order);
+    static void DrawUIById(int imageId, float x, float y);
+    static void DrawUIExById(int imageId, float x, float y, float r, float g, float b, float a, int sorting_order);
+
+private:
+    static std::unordered_map<std::string, int> idsByName;
+    static std::vector<std::string> names;
+};
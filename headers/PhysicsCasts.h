@@ -0,0 +1,62 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "RayCasting.h"
+
+// Batched rays and shape sweeps for Lua.
+//
+// Physics.RaycastBatch(origins, dirs, dists, results) casts one ray per entry of
+// origins/dirs (dists may be one number for every ray) and writes the first hit of
+// ray i into results[i], or false when it hit nothing. Pass the table it returned
+// last time back in as results: the HitResult userdata already in it are updated
+// in place, so a steady batch allocates nothing on the Lua side. Large batches are
+// split into chunks shared between the calling thread and a pool of workers that
+// is started on the first large batch and kept; b2World::RayCast only reads the
+// world, and the Lua tables are read and written on the calling thread.
+//
+// Physics.CircleCast(origin, radius, dir, dist) and Physics.BoxCast(origin, size,
+// dir, dist) sweep a shape along dir and return the first collider it touches as a
+// HitResult (fraction is the share of dist travelled), or nil. Triggers are ignored.
+class PhysicsCasts {
+public:
+    static luabridge::LuaRef RaycastBatch(luabridge::LuaRef origins, luabridge::LuaRef dirs, luabridge::LuaRef dists, luabridge::LuaRef results);
+    static luabridge::LuaRef CircleCast(Vector2 origin, float radius, Vector2 dir, float dist);
+    static luabridge::LuaRef BoxCast(Vector2 origin, Vector2 size, Vector2 dir, float dist);
+
+    // Batches at least this long are spread across threads; 0 disables threading
+    static size_t parallelThreshold;
+
+    // Joins the workers; they start again on the next large batch
+    static void Shutdown();
+
+private:
+    struct Ray {
+        b2Vec2 start;
+        b2Vec2 end;
+    };
+
+    static void castRange(const std::vector<Ray>& rays, std::vector<HitResult>& hits, std::vector<char>& didHit, size_t begin, size_t end);
+    static void castParallel(size_t count, size_t chunks);
+    static void castChunk(size_t chunk);
+    static void workerLoop();
+    static luabridge::LuaRef shapeCast(const b2Shape& shape, Vector2 origin, Vector2 dir, float dist);
+
+    // Reused between calls
+    static std::vector<Ray> rays;
+    static std::vector<HitResult> hits;
+    static std::vector<char> didHit;
+
+    // Worker pool; the chunk counters of the batch in progress are guarded by mutex
+    static std::vector<std::thread> workers;
+    static std::mutex mutex;
+    static std::condition_variable workReady;
+    static std::condition_variable workDone;
+    static size_t chunkSize;
+    static size_t chunkCount;
+    static size_t nextChunk;
+    static size_t chunksDone;
+    static bool stopping;
+};
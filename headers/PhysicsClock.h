@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include "RigidBody.h"
+
+// Fixed-timestep driver for RigidBody::Step. Each rendered frame adds the measured
+// frame time to an accumulator and the world is stepped in whole fixedStep slices,
+// so simulation speed no longer depends on the display's refresh rate. At most
+// maxSubsteps run per frame; time beyond that is dropped rather than carried over,
+// which keeps one slow frame from snowballing into more and more steps.
+//
+// Body poses from before the last step are kept so Rigidbody:GetPosition() and
+// GetRotation() can blend towards the current pose by the leftover fraction of a
+// step (Alpha()). Settings come from game.config: "physics_timestep" (seconds),
+// "physics_velocity_iterations", "physics_position_iterations",
+// "physics_max_substeps" and "physics_interpolation".
+class PhysicsClock {
+public:
+    // Advances the world by the time since the previous call. The headless build
+    // has no real frame time and takes exactly one step per call.
+    static void Advance(b2World* world);
+
+    // Forgets the accumulated time, e.g. after switching games
+    static void Reset();
+
+    // Restarts frame timing so the next Advance takes a single step instead of
+    // catching up on time that was not simulated (a scene load, a pause)
+    static void Resync() { lastMicros = 0; }
+
+    // Blend between the previous and current pose of body, if interpolating
+    static b2Vec2 InterpolatedPosition(const b2Body* body);
+    static float InterpolatedAngle(const b2Body* body);
+
+    // Call when a body is teleported or created so it is not blended from a stale pose
+    static void Forget(const b2Body* body);
+
+    // Destroys a Rigidbody's b2Body, if it still has one, and nulls the pointer
+    static void DestroyBody(b2Body*& body);
+
+    static float Alpha() { return alpha; }
+    static int StepsLastFrame() { return stepsLastFrame; }
+
+    static float fixedStep;
+    static int velocityIterations;
+    static int positionIterations;
+    static int maxSubsteps;
+    static bool interpolate;
+
+private:
+    struct Pose {
+        b2Vec2 position;
+        float angle;
+    };
+
+    static void snapshot(b2World* world);
+
+    static double accumulator;
+    static int64_t lastMicros;
+    static float alpha;
+    static int stepsLastFrame;
+    static std::unordered_map<const b2Body*, Pose> previousPoses;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <future>
+
+// Optional asynchronous physics ("async_physics": true in game.config). Box2D 2.4
+// solves its islands inside the private b2World::Solve, so the step itself stays
+// serial; what runs in parallel is the step and the frame's rendering. The whole
+// fixed-step update runs on one worker thread while the main thread renders:
+// BeginStep starts it once scripts are done for the frame, and FinishStep joins
+// it and dispatches the queued collision events where RigidBody::Step used to
+// run. Nothing between the two touches a body, and the step is the same one the
+// serial path takes, so results are identical either way. Only the windowed
+// build has rendering to overlap; measure it there with --frames (see main).
+class PhysicsWorker {
+public:
+    // Starts stepping the world in the background; does nothing when disabled
+    static void BeginStep();
+
+    // Waits for the background step and dispatches its contacts, or steps on this
+    // thread if no background step was started this frame
+    static void FinishStep();
+
+    // Blocks until a background step (if any) is done, without dispatching
+    static void Wait();
+
+    static bool enabled;
+
+private:
+    static std::future<void> pending;
+};
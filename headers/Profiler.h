@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class ProfileCategory {
+    Section,        // engine passes: lifecycle passes, physics step, event bus, rendering
+    ComponentType,  // Lua lifecycle calls grouped by component type
+    Actor           // Lua lifecycle calls grouped by actor name
+};
+
+// Rolling per-frame timings for one named section / component type / actor.
+struct ProfilerStat {
+    static const int kHistoryFrames = 120;
+
+    int64_t frameMicros = 0;   // accumulated during the current frame
+    uint64_t calls = 0;        // total samples recorded since the last reset
+    std::vector<float> historyMs = std::vector<float>(kHistoryFrames, 0.0f);
+
+    float AverageMs() const;
+    float PeakMs() const;
+};
+
+struct TraceEvent {
+    std::string name;
+    std::string detail;
+    const char* category;
+    int64_t startMicros;
+    int64_t durationMicros;
+};
+
+// Built-in frame profiler. Disabled by default; when enabled, every sample is
+// accumulated into per-frame stats (shown in the "Profiler" ImGui panel) and,
+// while captureTrace is set, kept as a Chrome trace event for DumpChromeTrace.
+class Profiler {
+public:
+    static void BeginFrame();
+    static void EndFrame();
+
+    static int64_t NowMicros();
+    static void AddSample(ProfileCategory category, const std::string& name, int64_t startMicros, int64_t durationMicros);
+
+    // Times one Lua lifecycle call; recorded under both its component type and its actor.
+    static void RecordComponentCall(const char* phase, const std::string& componentType, const std::string& actorName, int64_t startMicros);
+
+    // Writes the captured trace in Chrome's about:tracing / Perfetto JSON format.
+    static bool DumpChromeTrace(const std::string& path);
+    static void Reset();
+
+    static void RenderImGui();
+
+    static bool enabled;
+    static bool captureTrace;
+
+    static std::unordered_map<std::string, ProfilerStat> sections;
+    static std::unordered_map<std::string, ProfilerStat> componentTypes;
+    static std::unordered_map<std::string, ProfilerStat> actors;
+
+private:
+    static const size_t kMaxTraceEvents = 1000000;
+
+    static int64_t frameStartMicros;
+    static int historyIndex;
+    static std::vector<float> frameHistoryMs;
+    static std::vector<TraceEvent> traceEvents;
+};
+
+// RAII timer for a Section sample. Costs a single branch while the profiler is off.
+class ProfileScope {
+public:
+    ProfileScope(const char* sectionName);
+    ~ProfileScope();
+
+private:
+    const char* name;
+    int64_t start;
+    bool active;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "ImageDB.h"
+
+// Plain-old-data draw command. Same fields and field types as RenderRequest, but
+// the image is an ImageRegistry id instead of a std::string and the colour is
+// packed, so queuing a draw copies 48 bytes and never allocates.
+struct RenderCommand {
+    RenderRequest::ImageType type;
+    int32_t imageId;        // ImageRegistry id, -1 for pixels
+    float x, y;
+    int32_t sortingOrder;
+    int32_t rotationDegrees;
+    float scaleX, scaleY;
+    float pivotX, pivotY;   // -1 = centre
+    uint32_t color;         // 0xRRGGBBAA
+
+    // Defaults match RenderRequest: white, no rotation, unit scale, centred pivot
+    static RenderCommand Make(RenderRequest::ImageType type, int imageId, float x, float y, int sortingOrder) {
+        RenderCommand command;
+        command.type = type;
+        command.imageId = imageId;
+        command.x = x;
+        command.y = y;
+        command.sortingOrder = sortingOrder;
+        command.rotationDegrees = 0;
+        command.scaleX = 1.0f;
+        command.scaleY = 1.0f;
+        command.pivotX = -1.0f;
+        command.pivotY = -1.0f;
+        command.color = PackColor(255, 255, 255, 255);
+        return command;
+    }
+    static uint32_t PackColor(int r, int g, int b, int a) {
+        return (static_cast<uint32_t>(r & 0xFF) << 24) | (static_cast<uint32_t>(g & 0xFF) << 16) | (static_cast<uint32_t>(b & 0xFF) << 8) | static_cast<uint32_t>(a & 0xFF);
+    }
+    uint8_t R() const { return static_cast<uint8_t>(color >> 24); }
+    uint8_t G() const { return static_cast<uint8_t>(color >> 16); }
+    uint8_t B() const { return static_cast<uint8_t>(color >> 8); }
+    uint8_t A() const { return static_cast<uint8_t>(color); }
+};
+
+// Per-frame queue of draw commands, ordered with an LSD radix sort on a 64-bit key:
+//   bits 62-63 type (Scene, UI, Pixel)
+//   bits 30-61 sorting_order (sign-flipped so negatives sort first)
+//   bits  0-29 submission index
+// which is exactly the (type, sorting_order) stable order RenderFrame used to get
+// from std::stable_sort. With sortByTexture ("sort_by_texture" in rendering.config)
+// bits 20-29 hold the image id and bits 0-19 the submission index instead, so equal
+// sorting_order sprites are grouped by texture for the sprite batch at the cost of
+// no longer drawing them in call order.
+class RenderQueue {
+public:
+    static void Push(const RenderCommand& command) { commands.push_back(command); }
+
+    // The DrawUIEx / DrawEx commands, shared by the name and id draw variants
+    static void PushUIEx(int imageId, float x, float y, float r, float g, float b, float a, int sortingOrder);
+    static void PushSceneEx(int imageId, float x, float y, float rotation_degrees, float scale_x, float scale_y, float pivot_x, float pivot_y, float r, float g, float b, float a, int sortingOrder);
+
+    // Returns indices into Commands() in draw order.
+    static const std::vector<uint32_t>& Sort();
+    static const std::vector<RenderCommand>& Commands() { return commands; }
+
+    static size_t Size() { return commands.size(); }
+    static void Clear() { commands.clear(); }
+
+    static bool sortByTexture;
+
+    // Scene sprites skipped by RenderFrame because their rotated bounds miss the
+    // camera, and the ones that were submitted, for the last rendered frame.
+    // "cull_offscreen": false in rendering.config turns culling off.
+    static bool cullOffscreen;
+    static uint64_t frameCulled;
+    static uint64_t frameDrawn;
+
+private:
+    static std::vector<RenderCommand> commands;
+    static std::vector<uint64_t> keys;
+    static std::vector<uint64_t> scratchKeys;
+    static std::vector<uint32_t> order;
+    static std::vector<uint32_t> scratchOrder;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Actor.h"
+#include "CookedAsset.h"
+#include "AssetPreloader.h"
+
+class Renderer;
+
+// Background scene loading for Scene.LoadAsync(name). While the current scene
+// keeps running:
+//  1. a worker thread loads the scene (cooked file, or JSON compiled in memory)
+//     and has AssetPreloader collect and decode its images and sound effects;
+//  2. the main thread then builds the actors a few milliseconds per frame
+//     ("async_load_budget_ms" in game.config) without registering them, since
+//     anything touching Lua has to stay on the main thread;
+//  3. once every actor is built, the ordinary scene switch runs and registers the
+//     prepared actors in one frame and AssetPreloader uploads the decoded assets.
+// Scene.GetLoadProgress() goes from 0 to 1 over the three stages. A Scene.Load
+// for another scene cancels the background load.
+class SceneLoader {
+public:
+    // Lua
+    static void LoadAsync(const std::string& sceneName);
+    static float GetProgress();
+    static bool IsLoading();
+
+    // Main loop, once per frame after scripts ran and before physics starts.
+    // Requests the scene switch when the prepared scene is complete.
+    static void Update();
+
+    // Called by Scene::Update after the old scene is gone. Registers the prepared
+    // actors if they are for sceneName; returns false if the scene still has to
+    // be loaded synchronously.
+    static bool Commit(const std::string& sceneName, Renderer& renderer);
+
+    static void Cancel();
+    static void Clear();
+
+    // Name of the scene being loaded in the background, or empty
+    static const std::string& PendingScene();
+
+    // Builds (but does not register) actor index of a scene asset. verifiedTypes has
+    // one flag per string and records which component types were already checked.
+    static std::shared_ptr<Actor> BuildActor(const CookedAsset& scene, uint32_t index, std::vector<bool>& verifiedTypes);
+
+    static double stageBudgetMs;
+
+private:
+    struct Prepared {
+        CookedAsset scene;
+        DecodedAssets assets;
+        bool ok = false;
+    };
+
+    static void work(Prepared* target, std::string scenePath, std::string gameFolder);
+
+    static std::string sceneName;
+    static std::unique_ptr<Prepared> prepared;
+    static std::future<void> worker;
+    static std::vector<std::shared_ptr<Actor>> staged;
+    static std::vector<bool> verified;
+    static bool ready;
+
+    // Progress of the worker, written from its thread
+    static std::atomic<uint32_t> assetsTotal;
+    static std::atomic<uint32_t> assetsDone;
+    static std::atomic<bool> parsed;
+    static std::atomic<bool> decoded;
+    static std::atomic<bool> cancelled;
+};
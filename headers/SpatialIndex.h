@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Actor.h"
+#include "RigidBody.h"
+#include "Vector2.h"
+
+// Proximity queries for Lua (Physics.OverlapCircle / OverlapBox / Nearest).
+// Actors with a Rigidbody are found through Box2D's own broadphase, which the
+// world keeps up to date every step, and then tested against their fixtures'
+// exact shapes. Actors without one are placed in a uniform hash grid by scripts
+// calling Physics.Track(actor, pos) whenever they move; the entry is dropped
+// with Physics.Untrack or when the actor is destroyed.
+// Results are tables of actors ordered by actor id.
+class SpatialIndex {
+public:
+    static luabridge::LuaRef OverlapCircle(Vector2 center, float radius);
+    static luabridge::LuaRef OverlapBox(Vector2 center, Vector2 size);
+
+    // Closest actor called actorName to pos (body position or tracked point), or nil.
+    static luabridge::LuaRef Nearest(Vector2 pos, const std::string& actorName);
+
+    static void Track(Actor* actor, Vector2 pos);
+    static void Untrack(Actor* actor);
+
+    // Every fixture whose AABB overlaps bounds, from the world's broadphase
+    static std::vector<b2Fixture*> QueryFixtures(const b2AABB& bounds);
+
+    // Called by ActorRegistry when actors leave the scene
+    static void Remove(int actorId);
+    static void Clear();
+
+    // Width and height of a grid cell in world units
+    static float cellSize;
+
+private:
+    struct TrackedActor {
+        Actor* actor;
+        float x, y;
+        uint64_t cell;
+    };
+
+    static uint64_t cellKey(int cellX, int cellY);
+    static uint64_t cellOf(float x, float y);
+    static void removeFromCell(uint64_t cell, int actorId);
+
+    // Calls visit for every tracked actor whose cell overlaps the box
+    template <typename Visit>
+    static void forEachTrackedIn(float minX, float minY, float maxX, float maxY, Visit visit);
+
+    static void queryBodies(const b2Shape& shape, const b2Transform& transform, std::vector<Actor*>& found);
+    static luabridge::LuaRef toTable(std::vector<Actor*>& found);
+
+    static std::unordered_map<uint64_t, std::vector<int>> cells;
+    static std::unordered_map<int, TrackedActor> tracked;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "SDL.h"
+
+// Collects textured quads and submits them with one SDL_RenderGeometry call per
+// run of consecutive sprites that share a texture. Blend mode and colour/alpha
+// modulation live on the texture in SDL, so sharing a texture means sharing
+// blend state; the per-sprite colour goes into the vertices instead.
+class SpriteBatch {
+public:
+    // Queues one quad. destRect is in logical (unzoomed) pixels, center is the
+    // rotation pivot relative to destRect's top-left, and every coordinate is
+    // multiplied by scale (the camera zoom) when the vertices are built.
+    // srcRect selects part of the texture; nullptr means the whole texture.
+    static void Add(SDL_Renderer* renderer, SDL_Texture* texture, const SDL_Rect* srcRect, int textureWidth, int textureHeight,
+        const SDL_Rect& destRect, const SDL_FPoint& center, float rotationDegrees, float scale, SDL_Color color);
+
+    // Submits whatever is queued. Must be called before any other draw call that
+    // has to appear on top of the batched sprites.
+    static void Flush(SDL_Renderer* renderer);
+
+    // When false, RenderFrame falls back to one SDL_RenderCopyEx per request
+    // ("sprite_batching" in rendering.config).
+    static bool enabled;
+
+    static uint64_t frameBatches;
+    static uint64_t frameSprites;
+
+private:
+    static SDL_Texture* currentTexture;
+    static std::vector<SDL_Vertex> vertices;
+    static std::vector<int> indices;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include "SDL.h"
+#include "SDL_ttf.h"
+
+// LRU cache of rasterized strings, keyed by (font + size, colour, text). A label
+// that does not change is rasterized and uploaded once and afterwards costs a
+// single SDL_RenderCopy. Least recently drawn strings are evicted once the
+// textures exceed budgetBytes ("text_cache_budget_kb" in rendering.config).
+class TextCache {
+public:
+    // Returns the texture for text, rasterizing it on a miss. nullptr if SDL_ttf
+    // produced nothing (e.g. an empty string).
+    static SDL_Texture* Get(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, SDL_Color color, int& width, int& height);
+
+    // Must be called before the fonts or the renderer the textures belong to go away.
+    static void Clear();
+
+    static size_t BytesUsed() { return bytesUsed; }
+    static size_t EntryCount() { return lru.size(); }
+
+    static size_t budgetBytes;
+    static uint64_t hits;
+    static uint64_t misses;
+    static uint64_t evictions;
+
+private:
+    struct Entry {
+        std::string key;
+        SDL_Texture* texture;
+        int width;
+        int height;
+        size_t bytes;
+    };
+
+    static void evictToBudget();
+
+    static std::list<Entry> lru; // most recently used at the front
+    static std::unordered_map<std::string, std::list<Entry>::iterator> entries;
+    static size_t bytesUsed;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SDL.h"
+
+// Where an image lives inside an atlas page
+struct AtlasRegion {
+    SDL_Texture* page;
+    SDL_Rect rect;
+    int pageWidth;
+    int pageHeight;
+};
+
+// Packs every PNG under resources/<game>/images/ into a few large textures so the
+// sprite batch can draw a whole scene with a handful of texture binds. Renderer
+// builds it when a game is loaded, with the images decoded on ImageDecoder's
+// workers. Images that do not fit on a page are left to ImageDB's per-image
+// textures.
+// Set "texture_atlas": false in rendering.config to turn it off.
+class TextureAtlas {
+public:
+    // Packs the current game's images; does nothing but clear when disabled
+    static void Build(SDL_Renderer* renderer);
+
+    // Null until Build ran, or if the image is not in the atlas
+    static const AtlasRegion* Find(const std::string& imageName);
+
+    // Destroys the pages. Call before the renderer that owns them is destroyed.
+    static void Clear();
+
+    static size_t PageCount() { return pages.size(); }
+
+    static bool enabled;
+
+private:
+    static const int kPadding = 1;
+
+    static std::vector<SDL_Texture*> pages;
+    static std::unordered_map<std::string, AtlasRegion> regions;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SDL.h"
+
+// Keeps ImageDB's per-image textures within a memory budget. Atlas pages count
+// towards it as permanently referenced bytes; they are never evicted, so a large
+// atlas leaves less room for the rest. Each texture remembers the frame it was
+// last drawn and which scenes drew it; loading a different scene drops the
+// previous scene's references. Once a frame, EndFrame destroys
+//  - textures no scene references any more, once unused for idleFrames frames;
+//  - while over budgetBytes, the least recently drawn textures unused for
+//    idleFrames frames, unreferenced ones first.
+// ImageDB loads an evicted image again the next time it is drawn.
+// "texture_budget_mb" (0 = no budget) and "texture_idle_frames" in rendering.config.
+class TextureBudget {
+public:
+    // ImageDB hands over its cache so evictions can drop entries from it
+    static void Attach(std::unordered_map<std::string, SDL_Texture*>* imageCache);
+
+    // ImageDB, after creating a texture for imageName
+    static void Track(const std::string& imageName, SDL_Texture* texture);
+
+    // A draw of the texture this frame
+    static void Touch(int imageId);
+    static void Touch(const std::string& imageName);
+
+    // Scene::Update, when a scene is loaded; the previous scene's references go
+    // unless it is the same scene again
+    static void BeginScene(const std::string& sceneName);
+
+    static void EndFrame();
+
+    // ImageDB::clear, after it destroyed the textures
+    static void Clear();
+
+    // Bumped on every eviction; anything holding on to texture pointers re-resolves when it changes
+    static uint64_t Generation() { return generation; }
+    // TextureAtlas, after building or clearing its pages
+    static void SetPinnedBytes(size_t bytes) { pinnedBytes = bytes; }
+
+    static size_t BytesUsed() { return bytesUsed + pinnedBytes; }
+    static size_t TextureCount() { return resident; }
+
+    static size_t budgetBytes;
+    static uint64_t idleFrames;
+    static uint64_t evictions;
+    static uint64_t reloads;
+
+private:
+    struct Entry {
+        SDL_Texture* texture = nullptr;
+        size_t bytes = 0;
+        uint64_t lastUsedFrame = 0;
+        int lastScene = -2;      // last scene added to scenes; saves the search on most draws
+        std::vector<int> scenes; // scenes that drew it since they were loaded
+        bool loadedBefore = false;
+    };
+
+    static void reference(Entry& entry);
+    static void evict(int imageId);
+    static void evictToBudget();
+    static void sweepUnreferenced();
+
+    static const uint64_t kSweepInterval = 60;
+
+    static std::unordered_map<std::string, SDL_Texture*>* cache;
+    static std::vector<Entry> entries; // by image id
+    static std::unordered_map<std::string, int> sceneIds;
+    static int currentScene;
+    static uint64_t frame;
+    static uint64_t generation;
+    static size_t bytesUsed;
+    static size_t pinnedBytes;
+    static size_t resident;
+};
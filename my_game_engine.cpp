@@ -11,6 +11,7 @@
 #include <filesystem>
 #include <thread>
 #include <cstdint>
+#include <chrono>
 #include "headers/Helper.h"
 #include "headers/AudioHelper.h"
 #include "headers/Scene.h"
@@ -27,10 +28,22 @@
 #include "headers/Game.h"
 #include "box2d-2.4.1/box2d-2.4.1/include/box2d/box2d.h"
 
+#include "headers/Headless.h"
+#include "headers/Profiler.h"
+#include "headers/ActorRegistry.h"
+#include "headers/RenderQueue.h"
+#include "headers/PhysicsWorker.h"
+#include "headers/PhysicsClock.h"
+#include "headers/SceneLoader.h"
+#include "headers/AssetPreloader.h"
+#include "headers/TextureBudget.h"
+
+#ifndef ENGINE_HEADLESS
 #define IMGUI_ENABLE_DOCKING
 #include "imgui.h"
 #include "imgui_impl_sdl2.h"
 #include "imgui_impl_sdlrenderer2.h"
+#endif
 
 std::set<int> scoredActors;
 std::set<int> playedDialogueSFX;
@@ -39,6 +52,7 @@ bool gameOver = false;
 bool load_new_scene = false;    
 
 std::string gamePlaying = "ball_game";
+bool presentVsync = true; // off for "--frames" runs, so they measure the frame rather than the display
 
 std::vector<std::shared_ptr<Actor>> hardcoded_actors;
 
@@ -46,10 +60,6 @@ std::vector<std::shared_ptr<Actor>> hardcoded_actors;
 std::vector<std::pair<std::shared_ptr<Actor>, std::string>> contactdialogueEntries; // Pair actor ID with dialogue
 std::vector<std::pair<int, std::string>> dialogueEntries;
 
-// Initialize region sizes with zero to begin with.
-glm::vec2 REGION_SIZE_COLLISION(0, 0);
-glm::vec2 REGION_SIZE_TRIGGER(0, 0);
-
 unsigned long lastDamageFrame = 0;
 unsigned long damageCooldownFrames = 0;
 
@@ -66,13 +76,6 @@ int CAMERA_HEIGHT = DEFAULT_CAMERA_HEIGHT;
 void addActorsToGameWorld();
 
 
-// Function to create a composite key from two integers
-static uint64_t create_composite_key(const int x, const int y) {
-    auto x_ = static_cast<uint32_t>(x);
-    auto y_ = static_cast<uint32_t>(y);
-    return (static_cast<uint64_t>(x_) << 32) | static_cast<uint64_t>(y_);
-}
-
 static std::string obtain_word_after_phrase(const std::string& input, const std::string& phrase) {
     // Find the position of the phrase in the string
     size_t pos = input.find(phrase);
@@ -163,7 +166,7 @@ void checkAdjacentAndContactActors(CameraBounds& Camera, Renderer &Renderer, Tex
         }
         else if (newSceneExists && !gameOver) {
             //grid.clear();
-            hardcoded_actors.clear();
+            ActorRegistry::Clear();
             contactdialogueEntries.clear();
             dialogueEntries.clear();
             load_new_scene = false;
@@ -193,6 +196,17 @@ void updateActorPositions(glm::vec2& movement, AudioDB& audioDB) {
 
 int main(int argc, char* argv[])
 {
+    // "--game <folder>" runs another game under resources/, e.g. physics_benchmark
+    const std::string gameOption = Headless::ParseOption(argc, argv, "--game");
+    if (!gameOption.empty()) {
+        gamePlaying = gameOption;
+    }
+#ifndef ENGINE_HEADLESS
+    // "--frames N" runs N unpaused frames of the windowed loop, then prints the frame rate:
+    //   game_engine_linux --game physics_benchmark --frames 600
+    const int benchmarkFrames = Headless::ParseFrameCount(argc, argv, 0);
+    presentVsync = benchmarkFrames == 0;
+#endif
     // Load Lua
     LuaHelper lua_obj;
 
@@ -237,11 +251,69 @@ int main(int argc, char* argv[])
     std::vector<std::string> introTexts = textDB.getIntroTexts(config);
 
     AudioDB audioDB;
+    // Decoders are up now; warm the caches for the initial scene before its first frame
+    AssetPreloader::PreloadScene(sceneFilePath, Renderer.getRenderer());
     Renderer.currentState = GameState::Scene;
     glm::vec2 movementDirection(0.0f, 0.0f);
- 
-    while (Renderer.game_running) {
 
+#ifdef ENGINE_HEADLESS
+    // Headless: no input, no vsync, no pause menu. Run a fixed number of frames back to back.
+    const int frameLimit = Headless::ParseFrameCount(argc, argv, 600);
+    const std::string tracePath = Headless::ParseOption(argc, argv, "--trace");
+    if (!tracePath.empty()) {
+        Profiler::enabled = true;
+        Profiler::captureTrace = true;
+    }
+    gameState = Game::Running;
+
+    auto simulationStart = std::chrono::steady_clock::now();
+    int frame = 0;
+    for (; frame < frameLimit && Renderer.game_running; ++frame) {
+        Profiler::BeginFrame();
+        CameraBounds::calculateCameraPositions(Renderer.camera_offset_x, Renderer.camera_offset_y);
+
+        if (!hardcoded_actors.empty()) { Renderer.RenderActors(CameraBounds::cam_x_pos, CameraBounds::cam_y_pos, CameraBounds::zoom_factor); }
+
+        // Scripts are done with the bodies for this frame; step them while the frame renders
+        SceneLoader::Update();
+        if (!Scene::loadRequested) { PhysicsWorker::BeginStep(); }
+        Renderer.RenderFrame();
+
+        if (Scene::loadRequested) {
+            Scene::Update(Renderer);
+            Scene::loadRequested = false;
+            Profiler::EndFrame();
+            continue;
+        }
+
+        Input::LateUpdate();
+        EventBus::ProcessSubscriptions();
+        PhysicsWorker::FinishStep();
+        Actor::UpdateActors();
+        Profiler::EndFrame();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - simulationStart;
+    Headless::PrintSummary(frame, elapsed.count());
+    if (!tracePath.empty()) {
+        Profiler::DumpChromeTrace(tracePath);
+    }
+#else
+    // Every path through a windowed frame ends here, including the early continues
+    auto endFrame = []() {
+        TextureBudget::EndFrame();
+        Profiler::EndFrame();
+    };
+
+    if (benchmarkFrames > 0) {
+        gameState = Game::Running;
+    }
+    auto benchmarkStart = std::chrono::steady_clock::now();
+    int frame = 0;
+    while (Renderer.game_running && (benchmarkFrames == 0 || frame < benchmarkFrames)) {
+        ++frame;
+
+        Profiler::BeginFrame();
         Renderer.ProcessInput(movementDirection);
         // SDL_RenderClear(Renderer.getRenderer());
          // Render clear
@@ -249,7 +321,7 @@ int main(int argc, char* argv[])
         SDL_RenderClear(Renderer.getRenderer());
         if (Renderer.currentState == GameState::Intro) {
           //  Renderer.RenderIntro(imageDB, textDB, audioDB, introImages, introTexts);
-            if (Renderer.currentState == GameState::Scene) { continue; }
+            if (Renderer.currentState == GameState::Scene) { endFrame(); continue; }
         }
         else if (Renderer.currentState == GameState::Scene) {
             
@@ -260,17 +332,23 @@ int main(int argc, char* argv[])
 
             if (!hardcoded_actors.empty()) { Renderer.RenderActors(CameraBounds::cam_x_pos, CameraBounds::cam_y_pos, CameraBounds::zoom_factor); }
 
-            if (!ImageDB::requests.empty()) { Renderer.RenderFrame(); }
+            // Scripts are done with the bodies for this frame; step them while the frame renders
+            SceneLoader::Update();
+            if (gameState == Game::Running && !Scene::loadRequested) { PhysicsWorker::BeginStep(); }
+            if (RenderQueue::Size() > 0) { Renderer.RenderFrame(); }
             else { TextDB::RenderAllText(Renderer.getRenderer()); }
 
             if (Scene::loadRequested) {
                 SDL_RenderPresent(Renderer.getRenderer());
                 Scene::Update(Renderer);
                 Scene::loadRequested = false;
+                endFrame(); // scene loads are the hitches worth seeing
                 continue;
             }
 
             if (Renderer.currentState == GameState::Ending) {
+                PhysicsWorker::Wait(); // the step begun above must not outlive the frame
+                endFrame();
                 continue;
             }
         }
@@ -288,12 +366,26 @@ int main(int argc, char* argv[])
         if (gameState == Game::Running) {
             Input::LateUpdate();
             EventBus::ProcessSubscriptions();
-            RigidBody::Step();
+            PhysicsWorker::FinishStep();
             Actor::UpdateActors();
             SDL_RenderPresent(Renderer.getRenderer());
         }
+        else {
+            PhysicsClock::Resync(); // so unpausing does not replay the pause as catch-up steps
+        }
+
+        endFrame();
+    }
 
+    if (benchmarkFrames > 0) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - benchmarkStart;
+        std::cout << "benchmark: " << frame << " frames in " << elapsed.count() << "s";
+        if (elapsed.count() > 0.0) {
+            std::cout << " (" << (frame / elapsed.count()) << " fps)";
+        }
+        std::cout << std::endl;
     }
+#endif
     
     return 0;
 }
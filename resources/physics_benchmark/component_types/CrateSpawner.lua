@@ -0,0 +1,16 @@
+-- Drops a grid of dynamic crates into the walled pit on the first frame.
+CrateSpawner = {
+    count = 4000,
+    columns = 100,
+    spacing = 1.1,
+
+    OnStart = function(self)
+        local left = -(self.columns - 1) * self.spacing * 0.5
+        for i = 0, self.count - 1 do
+            local crate = Actor.Instantiate("Crate")
+            local body = crate:GetComponent("Rigidbody")
+            body.x = left + (i % self.columns) * self.spacing
+            body.y = 28.0 - math.floor(i / self.columns) * self.spacing
+        end
+    end
+}